@@ -7,12 +7,21 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "api/api_messages_search_merged.h"
 
+#include "data/data_messages_text_index.h"
+#include "data/data_session.h"
 #include "history/history.h"
 
 namespace Api {
 
+namespace {
+
+constexpr auto kLocalLimit = 100;
+
+} // namespace
+
 MessagesSearchMerged::MessagesSearchMerged(not_null<History*> history)
-: _apiSearch(history) {
+: _history(history)
+, _apiSearch(history) {
 	if (const auto migrated = history->migrateFrom()) {
 		_migratedSearch.emplace(migrated);
 	}
@@ -37,7 +46,8 @@ MessagesSearchMerged::MessagesSearchMerged(not_null<History*> history)
 
 	_apiSearch.messagesFounds(
 	) | rpl::start_with_next([=](const FoundMessages &data) {
-		if (data.nextToken == _concatedFound.nextToken) {
+		if (!base::take(_isLocal)
+			&& data.nextToken == _concatedFound.nextToken) {
 			addFound(data);
 			checkFull(data);
 			_nextFounds.fire({});
@@ -77,6 +87,7 @@ const FoundMessages &MessagesSearchMerged::messages() const {
 void MessagesSearchMerged::clear() {
 	_concatedFound = {};
 	_migratedFirstFound = {};
+	_isLocal = false;
 }
 
 void MessagesSearchMerged::search(const Request &search) {
@@ -87,6 +98,26 @@ void MessagesSearchMerged::search(const Request &search) {
 	_apiSearch.searchMessages(search);
 }
 
+void MessagesSearchMerged::searchLocal(const Request &search) {
+	if (search.query.isEmpty() || search.from || !search.tags.empty()) {
+		return;
+	}
+	auto messages = _history->owner().messagesTextIndex().search(
+		search.query,
+		_history,
+		kLocalLimit);
+	if (messages.empty()) {
+		return;
+	}
+	clear();
+	_isLocal = true;
+	_concatedFound = FoundMessages{
+		.total = int(messages.size()),
+		.messages = std::move(messages),
+	};
+	_localFounds.fire({});
+}
+
 void MessagesSearchMerged::searchMore() {
 	if (_migratedSearch && _isFull) {
 		_migratedSearch->searchMore();
@@ -103,4 +134,8 @@ rpl::producer<> MessagesSearchMerged::nextFounds() const {
 	return _nextFounds.events();
 }
 
+rpl::producer<> MessagesSearchMerged::localFounds() const {
+	return _localFounds.events();
+}
+
 } // namespace Api
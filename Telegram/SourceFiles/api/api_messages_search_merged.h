@@ -30,14 +30,20 @@ public:
 	void search(const Request &search);
 	void searchMore();
 
+	// Instant results from the loaded messages, until the server replies.
+	// They replace the current results only if something was found.
+	void searchLocal(const Request &search);
+
 	[[nodiscard]] const FoundMessages &messages() const;
 
 	[[nodiscard]] rpl::producer<> newFounds() const;
 	[[nodiscard]] rpl::producer<> nextFounds() const;
+	[[nodiscard]] rpl::producer<> localFounds() const;
 
 private:
 	void addFound(const FoundMessages &data);
 
+	const not_null<History*> _history;
 	MessagesSearch _apiSearch;
 
 	std::optional<MessagesSearch> _migratedSearch;
@@ -47,9 +53,11 @@ private:
 
 	bool _waitingForTotal = false;
 	bool _isFull = false;
+	bool _isLocal = false;
 
 	rpl::event_stream<> _newFounds;
 	rpl::event_stream<> _nextFounds;
+	rpl::event_stream<> _localFounds;
 
 	rpl::lifetime _lifetime;
 
@@ -145,6 +145,7 @@ private:
 	void removeRowFromSoundingMap(not_null<Row*> row);
 	void updateRowLevel(not_null<Row*> row, float level);
 	void checkRowPosition(not_null<Row*> row);
+	void reorderQueuedRows();
 	[[nodiscard]] bool needToReorder(not_null<Row*> row) const;
 	[[nodiscard]] bool allRowsAboveAreSpeaking(not_null<Row*> row) const;
 	[[nodiscard]] bool allRowsAboveMoreImportantThanHand(
@@ -183,6 +184,7 @@ private:
 	not_null<QWidget*> _menuParent;
 	base::unique_qptr<Ui::PopupMenu> _menu;
 	base::flat_set<not_null<PeerData*>> _menuCheckRowsAfterHidden;
+	std::vector<not_null<PeerData*>> _reorderQueue;
 
 	base::flat_map<PeerListRowId, crl::time> _raisedHandStatusRemoveAt;
 	base::Timer _raisedHandStatusRemoveTimer;
@@ -652,6 +654,46 @@ void Members::Controller::checkRowPosition(not_null<Row*> row) {
 		return;
 	}
 
+	// Many rows may start speaking at once in large calls,
+	// so sort the list only once for all of them.
+	const auto peer = row->peer();
+	_reorderQueue.erase(
+		ranges::remove(_reorderQueue, peer),
+		end(_reorderQueue));
+	_reorderQueue.push_back(peer);
+	if (_reorderQueue.size() == 1) {
+		crl::on_main(this, [=] {
+			reorderQueuedRows();
+		});
+	}
+}
+
+void Members::Controller::reorderQueuedRows() {
+	if (_menu) {
+		// The popup menu was shown after the rows were queued.
+		for (const auto &peer : base::take(_reorderQueue)) {
+			_menuCheckRowsAfterHidden.emplace(peer);
+		}
+		return;
+	}
+
+	// The later row was queued the higher it goes.
+	auto ranks = base::flat_map<const PeerListRow*, uint64>();
+	const auto queued = base::take(_reorderQueue);
+	for (auto i = 0, count = int(queued.size()); i != count; ++i) {
+		if (const auto row = findRow(queued[i])) {
+			ranks[row] = uint64(i + 1);
+		}
+	}
+	if (ranks.empty()) {
+		return;
+	}
+	const auto rank = [&](const PeerListRow &row) {
+		const auto i = ranks.find(&row);
+		return (i != end(ranks)) ? i->second : uint64(0);
+	};
+	const auto count = uint64(queued.size());
+
 	// Someone started speaking and has a non-speaking row above him.
 	// Or someone raised hand and has force muted above him.
 	// Or someone was forced muted and had can_unmute_self below him. Sort.
@@ -659,22 +701,22 @@ void Members::Controller::checkRowPosition(not_null<Row*> row) {
 	const auto projForAdmin = [&](const PeerListRow &other) {
 		const auto &real = static_cast<const Row&>(other);
 		return real.speaking()
-			// Speaking 'row' to the top, all other speaking below it.
-			? (&real == row.get() ? kTop : (kTop - 1))
+			// Queued speaking rows to the top, all other speaking below.
+			? (kTop - count + rank(real))
 			: (real.raisedHandRating() > 0)
 			// Then all raised hands sorted by rating.
 			? real.raisedHandRating()
 			: (real.state() == Row::State::Muted)
-			// All force muted at the bottom, but 'row' still above others.
-			? (&real == row.get() ? 1ULL : 0ULL)
+			// All force muted at the bottom, but queued still above others.
+			? (rank(real) ? 1ULL : 0ULL)
 			// All not force-muted lie between raised hands and speaking.
-			: (kTop - 2);
+			: (kTop - count - 1);
 	};
 	const auto projForOther = [&](const PeerListRow &other) {
 		const auto &real = static_cast<const Row&>(other);
 		return real.speaking()
-			// Speaking 'row' to the top, all other speaking below it.
-			? (&real == row.get() ? kTop : (kTop - 1))
+			// Queued speaking rows to the top, all other speaking below.
+			? (kTop - count + rank(real))
 			: 0ULL;
 	};
 
@@ -244,7 +244,7 @@ void Viewport::add(
 		track,
 		std::move(trackSize),
 		std::move(pinned),
-		[=] { widget()->update(); },
+		[=](QRect geometry) { widget()->update(geometry); },
 		self));
 
 	_tiles.back()->trackSizeValue(
@@ -49,6 +49,14 @@ void Viewport::RendererSW::paintFallback(
 	for (const auto &tile : _owner->_tiles) {
 		if (!tile->visible()) {
 			continue;
+		} else if (!clip.intersects(tile->geometry())) {
+			// Tiles repaint only their own geometry on new frames,
+			// so keep the others as they are, with their cached data.
+			if (const auto i = _tileData.find(tile.get())
+				; i != end(_tileData)) {
+				i->second.stale = false;
+			}
+			continue;
 		}
 		paintTile(p, tile.get(), bounding, bg);
 	}
@@ -70,17 +78,23 @@ void Viewport::RendererSW::validateUserpicFrame(
 		not_null<VideoTile*> tile,
 		TileData &data) {
 	if (!_userpicFrame) {
-		data.userpicFrame = QImage();
-		return;
-	} else if (!data.userpicFrame.isNull()) {
 		return;
 	}
+	const auto peer = tile->row()->peer();
+	auto &view = tile->row()->ensureUserpicView();
+	const auto key = peer->userpicUniqueKey(view);
 	const auto size = tile->trackOrUserpicSize();
+	if (!data.userpicFrame.isNull()
+		&& data.userpicKey == key
+		&& data.userpicFrame.width() == size.width()) {
+		return;
+	}
+
+	// Keep the blurred userpic while the tile switches between the video
+	// and the userpic, blurring is the most expensive part of the frame.
+	data.userpicKey = key;
 	data.userpicFrame = Images::BlurLargeImage(
-		tile->row()->peer()->generateUserpicImage(
-			tile->row()->ensureUserpicView(),
-			size.width(),
-			0),
+		peer->generateUserpicImage(view, size.width(), 0),
 		kBlurRadius);
 }
 
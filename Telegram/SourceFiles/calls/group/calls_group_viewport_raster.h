@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/round_rect.h"
 #include "ui/effects/cross_line.h"
 #include "ui/gl/gl_surface.h"
+#include "ui/image/image_location.h"
 #include "ui/text/text.h"
 
 namespace Calls::Group {
@@ -27,6 +28,7 @@ public:
 private:
 	struct TileData {
 		QImage userpicFrame;
+		InMemoryKey userpicKey;
 		QImage blurredFrame;
 		bool stale = false;
 	};
@@ -28,10 +28,10 @@ Viewport::VideoTile::VideoTile(
 	VideoTileTrack track,
 	rpl::producer<QSize> trackSize,
 	rpl::producer<bool> pinned,
-	Fn<void()> update,
+	Fn<void(QRect)> update,
 	bool self)
 : _endpoint(endpoint)
-, _update(std::move(update))
+, _update([=, update = std::move(update)] { update(_geometry); })
 , _track(std::move(track))
 , _trackSize(std::move(trackSize))
 , _rtmp(endpoint.rtmp())
@@ -28,7 +28,7 @@ public:
 		VideoTileTrack track,
 		rpl::producer<QSize> trackSize,
 		rpl::producer<bool> pinned,
-		Fn<void()> update,
+		Fn<void(QRect)> update,
 		bool self);
 
 	[[nodiscard]] not_null<Webrtc::VideoTrack*> track() const {
@@ -28,6 +28,8 @@ namespace {
 constexpr auto kRefreshEach = 60 * 60 * crl::time(1000); // 1 hour.
 constexpr auto kKeepNotUsedLangPacksCount = 4;
 constexpr auto kKeepNotUsedInputLanguagesCount = 4;
+constexpr auto kIndexMagic = quint32(0x58494B45); // "EKIX"
+constexpr auto kIndexFormat = qint32(1);
 
 using namespace Ui::Emoji;
 
@@ -44,6 +46,69 @@ struct LangPackData {
 	std::map<QString, std::vector<LangPackEmoji>> emoji;
 };
 
+// Lang pack keywords packed in one buffer, read from the cache file as is.
+//
+// Header, then (keysCount + 1) offsets of keys in the chars table,
+// (keysCount + 1) indices of the first emoji of each key,
+// (entriesCount + 1) offsets of emoji texts in the chars table
+// and the UTF-16 chars table itself. Keys are sorted.
+class LangPackIndex final {
+public:
+	LangPackIndex() = default;
+
+	[[nodiscard]] static QByteArray Pack(const LangPackData &data);
+	[[nodiscard]] static LangPackIndex FromBytes(QByteArray bytes);
+	[[nodiscard]] LangPackData unpack() const;
+
+	[[nodiscard]] bool valid() const {
+		return !_bytes.isEmpty();
+	}
+	[[nodiscard]] bool empty() const {
+		return !_keysCount;
+	}
+	[[nodiscard]] int version() const {
+		return _version;
+	}
+	void resetVersion() {
+		_version = 0;
+	}
+	[[nodiscard]] int maxKeyLength() const {
+		return _maxKeyLength;
+	}
+
+	[[nodiscard]] int keysCount() const {
+		return _keysCount;
+	}
+	[[nodiscard]] int lowerBound(QStringView key) const;
+	[[nodiscard]] QStringView key(int index) const;
+	[[nodiscard]] int entriesBegin(int key) const;
+	[[nodiscard]] int entriesEnd(int key) const;
+	[[nodiscard]] QStringView entry(int index) const;
+
+private:
+	struct Header {
+		quint32 magic = 0;
+		qint32 format = 0;
+		qint32 version = 0;
+		qint32 maxKeyLength = 0;
+		qint32 keysCount = 0;
+		qint32 entriesCount = 0;
+	};
+
+	[[nodiscard]] const qint32 *ints(int offset) const;
+	[[nodiscard]] QStringView chars(int from, int till) const;
+
+	QByteArray _bytes;
+	int _version = 0;
+	int _maxKeyLength = 0;
+	int _keysCount = 0;
+	int _keyTexts = 0;
+	int _keyEntries = 0;
+	int _entryTexts = 0;
+	int _chars = 0;
+
+};
+
 [[nodiscard]] bool MustAddPostfix(const QString &text) {
 	if (text.size() != 1) {
 		return false;
@@ -81,6 +146,187 @@ struct LangPackData {
 	return (length < text.size()) ? nullptr : result;
 }
 
+[[nodiscard]] EmojiPtr ResolveEmoji(const QString &text) {
+	return FindExact(MustAddPostfix(text)
+		? (text + QChar(Ui::Emoji::kPostfix))
+		: text);
+}
+
+QByteArray LangPackIndex::Pack(const LangPackData &data) {
+	if (!data.version && data.emoji.empty()) {
+		return QByteArray();
+	}
+	auto header = Header{
+		.magic = kIndexMagic,
+		.format = kIndexFormat,
+		.version = data.version,
+		.keysCount = int(data.emoji.size()),
+	};
+	auto keyTexts = std::vector<qint32>();
+	auto keyEntries = std::vector<qint32>();
+	auto entryTexts = std::vector<qint32>();
+	auto chars = QString();
+	keyTexts.reserve(header.keysCount + 1);
+	keyEntries.reserve(header.keysCount + 1);
+	for (const auto &[key, list] : data.emoji) {
+		keyTexts.push_back(chars.size());
+		keyEntries.push_back(header.entriesCount);
+		chars.append(key);
+		header.entriesCount += int(list.size());
+		accumulate_max(header.maxKeyLength, int(key.size()));
+	}
+	keyTexts.push_back(chars.size());
+	keyEntries.push_back(header.entriesCount);
+
+	// All emoji texts follow all the keys in the chars table.
+	entryTexts.reserve(header.entriesCount + 1);
+	for (const auto &[key, list] : data.emoji) {
+		for (const auto &entry : list) {
+			entryTexts.push_back(chars.size());
+			chars.append(entry.text);
+		}
+	}
+	entryTexts.push_back(chars.size());
+
+	auto result = QByteArray();
+	const auto append = [&](const auto &list) {
+		result.append(
+			reinterpret_cast<const char*>(list.data()),
+			list.size() * sizeof(qint32));
+	};
+	result.reserve(sizeof(Header)
+		+ (keyTexts.size() + keyEntries.size() + entryTexts.size())
+			* sizeof(qint32)
+		+ chars.size() * sizeof(QChar));
+	result.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+	append(keyTexts);
+	append(keyEntries);
+	append(entryTexts);
+	result.append(
+		reinterpret_cast<const char*>(chars.constData()),
+		chars.size() * sizeof(QChar));
+	return result;
+}
+
+LangPackIndex LangPackIndex::FromBytes(QByteArray bytes) {
+	auto header = Header();
+	if (bytes.size() < int(sizeof(Header))) {
+		return {};
+	}
+	memcpy(&header, bytes.constData(), sizeof(Header));
+	if (header.magic != kIndexMagic
+		|| header.format != kIndexFormat
+		|| header.version < 0
+		|| header.keysCount < 0
+		|| header.entriesCount < 0) {
+		return {};
+	}
+	const auto intsCount = (int64(header.keysCount) + 1) * 2
+		+ (int64(header.entriesCount) + 1);
+	const auto charsOffset = int64(sizeof(Header))
+		+ intsCount * sizeof(qint32);
+	const auto charsSize = int64(bytes.size()) - charsOffset;
+	if (charsSize < 0 || (charsSize % sizeof(QChar))) {
+		return {};
+	}
+	auto result = LangPackIndex();
+	result._bytes = std::move(bytes);
+	result._version = header.version;
+	result._maxKeyLength = header.maxKeyLength;
+	result._keysCount = header.keysCount;
+	result._keyTexts = sizeof(Header);
+	result._keyEntries = result._keyTexts
+		+ (header.keysCount + 1) * sizeof(qint32);
+	result._entryTexts = result._keyEntries
+		+ (header.keysCount + 1) * sizeof(qint32);
+	result._chars = int(charsOffset);
+
+	// Check the offsets once, so that queries don't have to.
+	const auto monotonic = [](const qint32 *list, int count, int limit) {
+		for (auto i = 0; i != count; ++i) {
+			if (list[i] < 0 || list[i] > list[i + 1]) {
+				return false;
+			}
+		}
+		return (list[0] >= 0) && (list[count] <= limit);
+	};
+	const auto charsCount = int(charsSize / sizeof(QChar));
+	if (!monotonic(
+			result.ints(result._keyTexts),
+			header.keysCount,
+			charsCount)
+		|| !monotonic(
+			result.ints(result._keyEntries),
+			header.keysCount,
+			header.entriesCount)
+		|| !monotonic(
+			result.ints(result._entryTexts),
+			header.entriesCount,
+			charsCount)) {
+		return {};
+	}
+	return result;
+}
+
+LangPackData LangPackIndex::unpack() const {
+	auto result = LangPackData{
+		.version = _version,
+		.maxKeyLength = _maxKeyLength,
+	};
+	for (auto i = 0; i != _keysCount; ++i) {
+		auto &list = result.emoji[key(i).toString()];
+		for (auto j = entriesBegin(i), till = entriesEnd(i); j != till; ++j) {
+			const auto text = entry(j).toString();
+			if (const auto emoji = ResolveEmoji(text)) {
+				list.push_back({ emoji, text });
+			}
+		}
+	}
+	return result;
+}
+
+const qint32 *LangPackIndex::ints(int offset) const {
+	return reinterpret_cast<const qint32*>(_bytes.constData() + offset);
+}
+
+QStringView LangPackIndex::chars(int from, int till) const {
+	const auto data = reinterpret_cast<const QChar*>(
+		_bytes.constData() + _chars);
+	return QStringView(data + from, data + till);
+}
+
+int LangPackIndex::lowerBound(QStringView key) const {
+	auto from = 0;
+	auto till = _keysCount;
+	while (from < till) {
+		const auto middle = from + (till - from) / 2;
+		if (this->key(middle).compare(key) < 0) {
+			from = middle + 1;
+		} else {
+			till = middle;
+		}
+	}
+	return from;
+}
+
+QStringView LangPackIndex::key(int index) const {
+	const auto offsets = ints(_keyTexts);
+	return chars(offsets[index], offsets[index + 1]);
+}
+
+int LangPackIndex::entriesBegin(int key) const {
+	return ints(_keyEntries)[key];
+}
+
+int LangPackIndex::entriesEnd(int key) const {
+	return ints(_keyEntries)[key + 1];
+}
+
+QStringView LangPackIndex::entry(int index) const {
+	const auto offsets = ints(_entryTexts);
+	return chars(offsets[index], offsets[index + 1]);
+}
+
 void CreateCacheFilePath() {
 	QDir().mkpath(internal::CacheFileFolder() + u"/keywords"_q);
 }
@@ -94,13 +340,9 @@ void CreateCacheFilePath() {
 	return internal::CacheFileFolder() + u"/keywords/"_q + id;
 }
 
-[[nodiscard]] LangPackData ReadLocalCache(const QString &id) {
-	auto file = QFile(CacheFilePath(id));
-	if (!file.open(QIODevice::ReadOnly)) {
-		return {};
-	}
+[[nodiscard]] LangPackData ReadLegacyCache(const QByteArray &bytes) {
 	auto result = LangPackData();
-	auto stream = QDataStream(&file);
+	auto stream = QDataStream(bytes);
 	stream.setVersion(QDataStream::Qt_5_1);
 	auto version = qint32();
 	auto count = qint32();
@@ -126,10 +368,7 @@ void CreateCacheFilePath() {
 			if (stream.status() != QDataStream::Ok) {
 				return {};
 			}
-			const auto emoji = MustAddPostfix(text)
-				? (text + QChar(Ui::Emoji::kPostfix))
-				: text;
-			const auto entry = LangPackEmoji{ FindExact(emoji), text };
+			const auto entry = LangPackEmoji{ ResolveEmoji(text), text };
 			if (!entry.emoji) {
 				return {};
 			}
@@ -141,8 +380,8 @@ void CreateCacheFilePath() {
 	return result;
 }
 
-void WriteLocalCache(const QString &id, const LangPackData &data) {
-	if (!data.version && data.emoji.empty()) {
+void WriteLocalCache(const QString &id, const QByteArray &packed) {
+	if (packed.isEmpty()) {
 		return;
 	}
 	CreateCacheFilePath();
@@ -150,19 +389,24 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 	if (!file.open(QIODevice::WriteOnly)) {
 		return;
 	}
-	auto stream = QDataStream(&file);
-	stream.setVersion(QDataStream::Qt_5_1);
-	stream
-		<< qint32(data.version)
-		<< qint32(data.emoji.size());
-	for (const auto &[key, list] : data.emoji) {
-		stream
-			<< key
-			<< qint32(list.size());
-		for (const auto &emoji : list) {
-			stream << emoji.text;
-		}
+	file.write(packed);
+}
+
+[[nodiscard]] LangPackIndex ReadLocalCache(const QString &id) {
+	auto file = QFile(CacheFilePath(id));
+	if (!file.open(QIODevice::ReadOnly)) {
+		return {};
 	}
+	auto bytes = file.readAll();
+	file.close();
+	if (auto result = LangPackIndex::FromBytes(bytes); result.valid()) {
+		return result;
+	}
+
+	// Convert the cache written by the older versions.
+	auto packed = LangPackIndex::Pack(ReadLegacyCache(bytes));
+	WriteLocalCache(id, packed);
+	return LangPackIndex::FromBytes(std::move(packed));
 }
 
 [[nodiscard]] QString NormalizeQuery(const QString &query) {
@@ -175,26 +419,32 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 
 void AppendFoundEmoji(
 		std::vector<Result> &result,
-		const QString &label,
-		const std::vector<LangPackEmoji> &list) {
+		const LangPackIndex &index,
+		int key) {
+	const auto from = index.entriesBegin(key);
+	const auto till = index.entriesEnd(key);
+
 	// It is important that the 'result' won't relocate while inserting.
-	result.reserve(result.size() + list.size());
+	result.reserve(result.size() + (till - from));
 	const auto alreadyBegin = begin(result);
 	const auto alreadyEnd = alreadyBegin + result.size();
 
-	auto &&add = ranges::views::all(
-		list
-	) | ranges::views::filter([&](const LangPackEmoji &entry) {
-		const auto i = ranges::find(
-			alreadyBegin,
-			alreadyEnd,
-			entry.emoji,
-			&Result::emoji);
-		return (i == alreadyEnd);
-	}) | ranges::views::transform([&](const LangPackEmoji &entry) {
-		return Result{ entry.emoji, label, entry.text };
-	});
-	result.insert(end(result), add.begin(), add.end());
+	auto label = QString();
+	for (auto i = from; i != till; ++i) {
+		auto text = index.entry(i).toString();
+		const auto emoji = ResolveEmoji(text);
+		if (!emoji
+			|| ranges::find(
+				alreadyBegin,
+				alreadyEnd,
+				emoji,
+				&Result::emoji) != alreadyEnd) {
+			continue;
+		} else if (label.isEmpty()) {
+			label = index.key(key).toString();
+		}
+		result.push_back({ emoji, label, std::move(text) });
+	}
 }
 
 void AppendLegacySuggestions(
@@ -257,10 +507,7 @@ void ApplyDifference(
 				keyword.vemoticons().v
 			) | ranges::views::transform([](const MTPstring &string) {
 				const auto text = qs(string);
-				const auto emoji = MustAddPostfix(text)
-					? (text + QChar(Ui::Emoji::kPostfix))
-					: text;
-				return LangPackEmoji{ FindExact(emoji), text };
+				return LangPackEmoji{ ResolveEmoji(text), text };
 			}) | ranges::views::filter([&](const LangPackEmoji &entry) {
 				if (!entry.emoji) {
 					LOG(("API Warning: emoji %1 is not supported, word: %2."
@@ -334,12 +581,12 @@ private:
 
 	void readLocalCache();
 	void applyDifference(const MTPEmojiKeywordsDifference &result);
-	void applyData(LangPackData &&data);
+	void applyData(LangPackIndex &&data);
 
 	not_null<Delegate*> _delegate;
 	QString _id;
 	State _state = State::ReadingCache;
-	LangPackData _data;
+	LangPackIndex _data;
 	crl::time _lastRefreshTime = 0;
 	mtpRequestId _requestId = 0;
 	base::binary_guard _guard;
@@ -365,7 +612,7 @@ EmojiKeywords::LangPack::~LangPack() {
 void EmojiKeywords::LangPack::readLocalCache() {
 	const auto id = _id;
 	auto callback = crl::guard(_guard.make_guard(), [=](
-			LangPackData &&result) {
+			LangPackIndex &&result) {
 		applyData(std::move(result));
 		refresh();
 	});
@@ -408,10 +655,10 @@ void EmojiKeywords::LangPack::refresh() {
 			_lastRefreshTime = crl::now();
 		}).send();
 	};
-	_requestId = (_data.version > 0)
+	_requestId = (_data.version() > 0)
 		? send(MTPmessages_GetEmojiKeywordsDifference(
 			MTP_string(_id),
-			MTP_int(_data.version)))
+			MTP_int(_data.version())))
 		: send(MTPmessages_GetEmojiKeywords(
 			MTP_string(_id)));
 }
@@ -426,26 +673,28 @@ void EmojiKeywords::LangPack::applyDifference(
 			LOG(("API Error: Bad lang_code for emoji keywords %1 -> %2").arg(
 				_id,
 				code));
-			_data.version = 0;
+			_data.resetVersion();
 			_state = State::Refreshed;
 			return;
-		} else if (keywords.isEmpty() && _data.version >= version) {
+		} else if (keywords.isEmpty() && _data.version() >= version) {
 			_state = State::Refreshed;
 			return;
 		}
 		const auto id = _id;
 		auto copy = _data;
 		auto callback = crl::guard(_guard.make_guard(), [=](
-				LangPackData &&result) {
+				LangPackIndex &&result) {
 			applyData(std::move(result));
 		});
 		crl::async([=,
 			copy = std::move(copy),
 			callback = std::move(callback)]() mutable {
-			ApplyDifference(copy, keywords, version);
-			WriteLocalCache(id, copy);
+			auto data = copy.unpack();
+			ApplyDifference(data, keywords, version);
+			auto packed = LangPackIndex::Pack(data);
+			WriteLocalCache(id, packed);
 			crl::on_main([
-				result = std::move(copy),
+				result = LangPackIndex::FromBytes(std::move(packed)),
 				callback = std::move(callback)
 			]() mutable {
 				callback(std::move(result));
@@ -454,7 +703,7 @@ void EmojiKeywords::LangPack::applyDifference(
 	});
 }
 
-void EmojiKeywords::LangPack::applyData(LangPackData &&data) {
+void EmojiKeywords::LangPack::applyData(LangPackIndex &&data) {
 	_data = std::move(data);
 	_state = State::Refreshed;
 	_delegate->langPackRefreshed();
@@ -473,30 +722,25 @@ void EmojiKeywords::LangPack::apiChanged() {
 std::vector<Result> EmojiKeywords::LangPack::query(
 		const QString &normalized,
 		bool exact) const {
-	if (normalized.size() > _data.maxKeyLength
-		|| _data.emoji.empty()
+	if (normalized.size() > _data.maxKeyLength()
+		|| _data.empty()
 		|| (exact && SkipExactKeyword(_id, normalized))) {
 		return {};
 	}
 
-	const auto from = _data.emoji.lower_bound(normalized);
-	auto &&chosen = ranges::make_subrange(
-		from,
-		end(_data.emoji)
-	) | ranges::views::take_while([&](const auto &pair) {
-		const auto &key = pair.first;
-		return exact ? (key == normalized) : key.startsWith(normalized);
-	});
-
 	auto result = std::vector<Result>();
-	for (const auto &[key, list] : chosen) {
-		AppendFoundEmoji(result, key, list);
+	for (auto i = _data.lowerBound(normalized); i != _data.keysCount(); ++i) {
+		const auto key = _data.key(i);
+		if (exact ? (key != normalized) : !key.startsWith(normalized)) {
+			break;
+		}
+		AppendFoundEmoji(result, _data, i);
 	}
 	return result;
 }
 
 int EmojiKeywords::LangPack::maxQueryLength() const {
-	return _data.maxKeyLength;
+	return _data.maxKeyLength();
 }
 
 EmojiKeywords::EmojiKeywords() {
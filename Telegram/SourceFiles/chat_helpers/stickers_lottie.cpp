@@ -21,10 +21,114 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/painter.h"
 #include "main/main_session.h"
 
+#include <QtCore/QMutex>
+
 namespace ChatHelpers {
 namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
+constexpr auto kSharedCacheLimit = int64(8 * 1024 * 1024);
+constexpr auto kSharedCacheLogEach = 256;
+
+// Packed frame caches are shared between all players of the same
+// document / size / colour replacements, so that a sticker visible
+// in the history, the panel and the reactions at once is read from
+// the big file cache only once while it stays hot. Only the packed
+// blobs are kept here, the players still unpack their own frames,
+// so the budget is kept small: it only has to cover the stickers
+// that are on the screen several times at once.
+class SharedFrameCache final {
+public:
+	using Key = std::pair<uint64, uint64>;
+
+	[[nodiscard]] std::optional<QByteArray> get(Key key);
+	void put(Key key, const QByteArray &data);
+
+private:
+	struct Entry {
+		Key key;
+		QByteArray data;
+	};
+	struct KeyHash {
+		size_t operator()(const Key &key) const {
+			return std::hash<uint64>()(key.first ^ (key.second << 1));
+		}
+	};
+	using Entries = std::list<Entry>;
+
+	void countLookup(bool hit);
+	void evictOverBudget();
+
+	QMutex _mutex;
+	Entries _lru; // Most recently used first.
+	std::unordered_map<Key, Entries::iterator, KeyHash> _entries;
+	int64 _total = 0;
+	int _hits = 0;
+	int _misses = 0;
+	int _evicted = 0;
+
+};
+
+std::optional<QByteArray> SharedFrameCache::get(Key key) {
+	QMutexLocker lock(&_mutex);
+	const auto i = _entries.find(key);
+	const auto hit = (i != end(_entries));
+	countLookup(hit);
+	if (!hit) {
+		return std::nullopt;
+	}
+	_lru.splice(begin(_lru), _lru, i->second);
+	return i->second->data;
+}
+
+void SharedFrameCache::put(Key key, const QByteArray &data) {
+	if (data.isEmpty() || data.size() > kSharedCacheLimit / 4) {
+		return;
+	}
+	QMutexLocker lock(&_mutex);
+	const auto i = _entries.find(key);
+	if (i != end(_entries)) {
+		_total += int64(data.size()) - int64(i->second->data.size());
+		i->second->data = data;
+		_lru.splice(begin(_lru), _lru, i->second);
+	} else {
+		_total += data.size();
+		_lru.push_front({ key, data });
+		_entries.emplace(key, begin(_lru));
+	}
+	evictOverBudget();
+}
+
+void SharedFrameCache::countLookup(bool hit) {
+	++(hit ? _hits : _misses);
+	const auto lookups = _hits + _misses;
+	if (lookups % kSharedCacheLogEach) {
+		return;
+	}
+	DEBUG_LOG(("Lottie Cache: %1 entries, %2 bytes, "
+		"%3 hits / %4 lookups (%5%), %6 evicted."
+		).arg(_entries.size()
+		).arg(_total
+		).arg(_hits
+		).arg(lookups
+		).arg(_hits * 100 / lookups
+		).arg(_evicted));
+}
+
+void SharedFrameCache::evictOverBudget() {
+	while (_total > kSharedCacheLimit && !_lru.empty()) {
+		const auto &last = _lru.back();
+		_total -= last.data.size();
+		_entries.erase(last.key);
+		_lru.pop_back();
+		++_evicted;
+	}
+}
+
+[[nodiscard]] SharedFrameCache &SharedCache() {
+	static auto result = SharedFrameCache();
+	return result;
+}
 
 } // namespace
 
@@ -44,13 +148,22 @@ auto LottieCachedFromContent(
 		baseKey.high,
 		baseKey.low + keyShift
 	};
+	const auto shared = SharedFrameCache::Key{ key.high, key.low };
 	const auto get = [=](FnMut<void(QByteArray &&cached)> handler) {
-		session->data().cacheBigFile().get(
-			key,
-			std::move(handler));
+		if (auto cached = SharedCache().get(shared)) {
+			handler(base::take(*cached));
+			return;
+		}
+		auto done = [=, handler = std::move(handler)](
+				QByteArray &&cached) mutable {
+			SharedCache().put(shared, cached);
+			handler(std::move(cached));
+		};
+		session->data().cacheBigFile().get(key, std::move(done));
 	};
 	const auto weak = base::make_weak(session);
 	const auto put = [=](QByteArray &&cached) {
+		SharedCache().put(shared, cached);
 		crl::on_main(weak, [=, data = std::move(cached)]() mutable {
 			weak->data().cacheBigFile().put(key, std::move(data));
 		});
@@ -28,6 +28,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/streamed_file_downloader.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
+#include "storage/file_download_writer.h"
 #include "base/options.h"
 #include "history/history.h"
 #include "history/history_item.h"
@@ -96,7 +97,8 @@ QString FileNameUnsafe(
 		const QString &prefix,
 		QString name,
 		bool savingAs,
-		const QDir &dir) {
+		const QDir &dir,
+		Fn<bool(const QString &)> canResume) {
 	name = base::FileNameFromUserString(name);
 	if (Core::App().settings().askDownloadPath() || savingAs) {
 		if (!name.isEmpty() && name.at(0) == QChar::fromLatin1('.')) {
@@ -172,7 +174,13 @@ QString FileNameUnsafe(
 	}
 	QString nameBase = path + nameStart;
 	name = nameBase + extension;
-	for (int i = 0; QFileInfo::exists(name); ++i) {
+	const auto taken = [&](const QString &name) {
+		// Don't write over an unfinished download of some other file.
+		return QFileInfo::exists(name)
+			|| (Storage::HasUnfinishedDownload(name)
+				&& !(canResume && canResume(name)));
+	};
+	for (int i = 0; taken(name); ++i) {
 		name = nameBase + u" (%1)"_q.arg(i + 2) + extension;
 	}
 
@@ -187,7 +195,8 @@ QString FileNameForSave(
 		const QString &prefix,
 		QString name,
 		bool savingAs,
-		const QDir &dir) {
+		const QDir &dir,
+		Fn<bool(const QString &)> canResume) {
 	const auto result = FileNameUnsafe(
 		session,
 		title,
@@ -195,7 +204,8 @@ QString FileNameForSave(
 		prefix,
 		name,
 		savingAs,
-		dir);
+		dir,
+		std::move(canResume));
 #ifdef Q_OS_WIN
 	const auto lower = result.trimmed().toLower();
 	const auto kBadExtensions = { u".lnk"_q, u".scf"_q };
@@ -258,6 +268,12 @@ QString DocumentFileNameForSave(
 		prefix = u"doc"_q;
 	}
 
+	// An interrupted download of this file is continued at the same path.
+	const auto size = data->size;
+	const auto key = data->cacheKey();
+	const auto canResume = [=](const QString &path) {
+		return Storage::CanResumeDownload(path, size, key);
+	};
 	return FileNameForSave(
 		&data->session(),
 		caption,
@@ -265,7 +281,8 @@ QString DocumentFileNameForSave(
 		prefix,
 		name,
 		forceSavingAs,
-		dir);
+		dir,
+		canResume);
 }
 
 Data::FileOrigin StickerData::setOrigin() const {
@@ -1056,9 +1073,16 @@ void DocumentData::handleLoaderUpdates() {
 				Ui::hideLayer();
 				save(origin, failedFileName);
 			};
+			const auto declined = [=] {
+				// Nobody will resume it, remove the loaded parts.
+				if (!failedFileName.isEmpty()) {
+					Storage::RemoveUnfinishedDownload(failedFileName);
+				}
+			};
 			Ui::show(Ui::MakeConfirmBox({
-				tr::lng_download_finish_failed(),
-				crl::guard(&session(), retry)
+				.text = tr::lng_download_finish_failed(),
+				.confirmed = crl::guard(&session(), retry),
+				.cancelled = declined,
 			}));
 		} else if (error.failureReason == FailureReason::FileWriteFailure) {
 			if (!Core::App().settings().downloadPath().isEmpty()) {
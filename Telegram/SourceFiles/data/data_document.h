@@ -383,7 +383,8 @@ QString FileNameForSave(
 	const QString &prefix,
 	QString name,
 	bool savingAs,
-	const QDir &dir = QDir());
+	const QDir &dir = QDir(),
+	Fn<bool(const QString &)> canResume = nullptr);
 
 QString DocumentFileNameForSave(
 	not_null<const DocumentData*> data,
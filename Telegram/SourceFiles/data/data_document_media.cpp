@@ -87,10 +87,30 @@ enum class FileType {
 		|| (size.width() * size.height() > kReadAreaLimit)) {
 		return QImage();
 	}
+	const auto limit = QSize(
+		kWallPaperThumbnailLimit,
+		kWallPaperThumbnailLimit);
+	if (size.isValid()
+		&& (size.width() > limit.width()
+			|| size.height() > limit.height())) {
+		// JPEG decoder uses DCT scaling for that and never allocates
+		// the full resolution frame, other formats scale after decoding.
+		reader.setScaledSize(size.scaled(limit, Qt::KeepAspectRatio));
+	}
+	const auto started = crl::now();
 	auto result = reader.read();
 	if (!result.width() || !result.height()) {
 		return QImage();
 	}
+	DEBUG_LOG(("Media Info: thumbnail of %1x%2 %3 decoded to %4x%5 "
+		"(%6 KB) in %7 ms."
+		).arg(size.width()
+		).arg(size.height()
+		).arg(QString::fromLatin1(reader.format())
+		).arg(result.width()
+		).arg(result.height()
+		).arg(result.sizeInBytes() / 1024
+		).arg(crl::now() - started));
 	return (result.width() > kWallPaperThumbnailLimit
 		|| result.height() > kWallPaperThumbnailLimit)
 		? result.scaled(
@@ -243,8 +243,21 @@ const GroupCallParticipant *GroupCall::participantByPeer(
 
 GroupCallParticipant *GroupCall::findParticipant(
 		not_null<PeerData*> peer) {
-	const auto i = ranges::find(_participants, peer, &Participant::peer);
-	return (i != end(_participants)) ? &*i : nullptr;
+	const auto i = _participantIndexByPeer.find(peer);
+	return (i != end(_participantIndexByPeer))
+		? &_participants[i->second]
+		: nullptr;
+}
+
+void GroupCall::eraseParticipant(std::vector<Participant>::iterator i) {
+	const auto index = int(i - begin(_participants));
+	_participantIndexByPeer.remove(i->peer);
+	_participants.erase(i);
+	for (auto &[peer, already] : _participantIndexByPeer) {
+		if (already > index) {
+			--already;
+		}
+	}
 }
 
 const GroupCallParticipant *GroupCall::participantByEndpoint(
@@ -369,6 +382,7 @@ void GroupCall::processFullCallFields(const MTPphone_GroupCall &call) {
 		const auto nextOffset = qs(data.vparticipants_next_offset());
 		data.vcall().match([&](const MTPDgroupCall &data) {
 			_participants.clear();
+			_participantIndexByPeer.clear();
 			_speakingByActiveFinishes.clear();
 			_participantPeerByAudioSsrc.clear();
 			_allParticipantsLoaded = false;
@@ -567,10 +581,10 @@ void GroupCall::applyParticipantsSlice(
 			const auto participantPeerId = peerFromMTP(data.vpeer());
 			const auto participantPeer = _peer->owner().peer(
 				participantPeerId);
-			const auto i = ranges::find(
-				_participants,
-				participantPeer,
-				&Participant::peer);
+			const auto index = _participantIndexByPeer.find(participantPeer);
+			const auto i = (index != end(_participantIndexByPeer))
+				? (begin(_participants) + index->second)
+				: end(_participants);
 			if (data.is_left()) {
 				if (i != end(_participants)) {
 					auto update = ParticipantUpdate{
@@ -580,7 +594,7 @@ void GroupCall::applyParticipantsSlice(
 					_participantPeerByAudioSsrc.erase(
 						GetAdditionalAudioSsrc(i->videoParams));
 					_speakingByActiveFinishes.remove(participantPeer);
-					_participants.erase(i);
+					eraseParticipant(i);
 					if (sliceSource != ApplySliceSource::FullReloaded) {
 						_participantUpdates.fire(std::move(update));
 					}
@@ -662,6 +676,9 @@ void GroupCall::applyParticipantsSlice(
 						additional,
 						participantPeer);
 				}
+				_participantIndexByPeer.emplace(
+					participantPeer,
+					int(_participants.size()));
 				_participants.push_back(value);
 				if (const auto user = participantPeer->asUser()) {
 					_peer->owner().unregisterInvitedToCallUser(_id, user);
@@ -914,11 +931,7 @@ void GroupCall::requestUnknownParticipants() {
 		}
 		for (const auto &[id, when] : participantPeerIds) {
 			if (const auto participantPeer = _peer->owner().peerLoaded(id)) {
-				const auto isParticipant = ranges::contains(
-					_participants,
-					not_null{ participantPeer },
-					&Participant::peer);
-				if (isParticipant) {
+				if (_participantIndexByPeer.contains(participantPeer)) {
 					applyActiveUpdate(id, when, participantPeer);
 				}
 			}
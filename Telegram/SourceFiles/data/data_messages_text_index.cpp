@@ -0,0 +1,186 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_messages_text_index.h"
+
+#include "history/history.h"
+#include "history/history_item.h"
+
+namespace Data {
+
+void MessagesTextIndex::update(not_null<HistoryItem*> item) {
+	auto words = Words(item->originalText());
+	const auto i = _words.find(item);
+	if (i != end(_words)) {
+		if (i->second == words) {
+			return;
+		}
+		removeWords(item, i->second);
+		if (words.empty()) {
+			_words.erase(i);
+			return;
+		}
+		addWords(item, words);
+		i->second = std::move(words);
+	} else if (!words.empty()) {
+		addWords(item, words);
+		_words.emplace(item, std::move(words));
+	}
+}
+
+void MessagesTextIndex::remove(not_null<HistoryItem*> item) {
+	const auto i = _words.find(item);
+	if (i == end(_words)) {
+		return;
+	}
+	removeWords(item, i->second);
+	_words.erase(i);
+}
+
+void MessagesTextIndex::addWords(
+		not_null<HistoryItem*> item,
+		const std::vector<QString> &words) {
+	auto &index = _histories[item->history()];
+	for (const auto &word : words) {
+		auto &items = index[word];
+		items.insert(ranges::lower_bound(items, item), item);
+	}
+}
+
+void MessagesTextIndex::removeWords(
+		not_null<HistoryItem*> item,
+		const std::vector<QString> &words) {
+	const auto i = _histories.find(item->history());
+	if (i == end(_histories)) {
+		return;
+	}
+	auto &index = i->second;
+	for (const auto &word : words) {
+		const auto j = index.find(word);
+		if (j == end(index)) {
+			continue;
+		}
+		auto &items = j->second;
+		const auto k = ranges::lower_bound(items, item);
+		if (k != end(items) && *k == item) {
+			items.erase(k);
+		}
+		if (items.empty()) {
+			index.erase(j);
+		}
+	}
+	if (index.empty()) {
+		_histories.erase(i);
+	}
+}
+
+std::vector<QString> MessagesTextIndex::Words(const TextWithEntities &text) {
+	if (text.text.isEmpty()) {
+		return {};
+	}
+	const auto prepared = TextUtilities::PrepareSearchWords(text.text);
+	auto result = std::vector<QString>(prepared.begin(), prepared.end());
+
+	// Find '#hashtag' and '@mention' by their full text as well.
+	for (const auto &entity : text.entities) {
+		const auto type = entity.type();
+		if (type == EntityType::Hashtag
+			|| type == EntityType::Cashtag
+			|| type == EntityType::Mention
+			|| type == EntityType::BotCommand) {
+			result.push_back(text.text.mid(
+				entity.offset(),
+				entity.length()).toLower());
+		}
+	}
+	ranges::sort(result);
+	result.erase(ranges::unique(result), end(result));
+	return result;
+}
+
+auto MessagesTextIndex::Collect(
+		const Index &index,
+		const QString &prefix) -> Items {
+	auto result = Items();
+	auto merged = Items();
+	for (auto i = index.lower_bound(prefix); i != end(index); ++i) {
+		if (!i->first.startsWith(prefix)) {
+			break;
+		} else if (result.empty()) {
+			result = i->second;
+			continue;
+		}
+		merged.clear();
+		merged.reserve(result.size() + i->second.size());
+		std::set_union(
+			begin(result),
+			end(result),
+			begin(i->second),
+			end(i->second),
+			std::back_inserter(merged));
+		std::swap(result, merged);
+	}
+	return result;
+}
+
+auto MessagesTextIndex::Search(
+		const Index &index,
+		const QStringList &words) -> Items {
+	auto result = Collect(index, words.front());
+	auto intersected = Items();
+	for (auto i = 1; i < words.size() && !result.empty(); ++i) {
+		const auto items = Collect(index, words[i]);
+		intersected.clear();
+		std::set_intersection(
+			begin(result),
+			end(result),
+			begin(items),
+			end(items),
+			std::back_inserter(intersected));
+		std::swap(result, intersected);
+	}
+	return result;
+}
+
+MessageIdsList MessagesTextIndex::search(
+		const QString &query,
+		not_null<History*> history,
+		int limit) const {
+	const auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty()) {
+		return {};
+	}
+	auto list = std::vector<not_null<HistoryItem*>>();
+	for (const auto searched : { history.get(), history->migrateFrom() }) {
+		const auto i = searched
+			? _histories.find(searched)
+			: end(_histories);
+		if (i == end(_histories)) {
+			continue;
+		}
+		const auto found = Search(i->second, words);
+		list.reserve(list.size() + found.size());
+		for (const auto &item : found) {
+			if (item->isRegular()) {
+				list.push_back(item);
+			}
+		}
+	}
+	ranges::sort(list, ranges::greater(), [](not_null<HistoryItem*> item) {
+		return std::make_pair(item->date(), item->id);
+	});
+	if (limit > 0 && int(list.size()) > limit) {
+		list.resize(limit);
+	}
+	return ranges::views::all(
+		list
+	) | ranges::views::transform(
+		&HistoryItem::fullId
+	) | ranges::to<MessageIdsList>();
+}
+
+} // namespace Data
@@ -0,0 +1,58 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class History;
+class HistoryItem;
+
+namespace Data {
+
+// Words of the loaded messages texts, for instant local search results.
+class MessagesTextIndex final {
+public:
+	void update(not_null<HistoryItem*> item);
+	void remove(not_null<HistoryItem*> item);
+
+	// All query words should be prefixes of some words of the message.
+	// Newest messages first, from the history and from the history
+	// it was migrated from.
+	[[nodiscard]] MessageIdsList search(
+		const QString &query,
+		not_null<History*> history,
+		int limit = 0) const;
+
+private:
+	// Sorted by pointer, so that lists could be merged and intersected.
+	using Items = std::vector<not_null<HistoryItem*>>;
+	using Index = std::map<QString, Items>;
+
+	[[nodiscard]] static std::vector<QString> Words(
+		const TextWithEntities &text);
+	[[nodiscard]] static Items Collect(
+		const Index &index,
+		const QString &prefix);
+	[[nodiscard]] static Items Search(
+		const Index &index,
+		const QStringList &words);
+
+	void addWords(
+		not_null<HistoryItem*> item,
+		const std::vector<QString> &words);
+	void removeWords(
+		not_null<HistoryItem*> item,
+		const std::vector<QString> &words);
+
+	// Separate for each history, so that a chat search scans only it.
+	std::unordered_map<not_null<History*>, Index> _histories;
+	std::unordered_map<
+		not_null<HistoryItem*>,
+		std::vector<QString>> _words;
+
+};
+
+} // namespace Data
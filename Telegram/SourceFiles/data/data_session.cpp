@@ -69,6 +69,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_stories.h"
 #include "data/data_streaming.h"
 #include "data/data_media_rotation.h"
+#include "data/data_messages_text_index.h"
 #include "data/data_histories.h"
 #include "data/data_peer_values.h"
 #include "data/data_premium_limits.h"
@@ -262,6 +263,7 @@ Session::Session(not_null<Main::Session*> session)
 , _sendActionManager(std::make_unique<SendActionManager>())
 , _streaming(std::make_unique<Streaming>(this))
 , _mediaRotation(std::make_unique<MediaRotation>())
+, _messagesTextIndex(std::make_unique<MessagesTextIndex>())
 , _histories(std::make_unique<Histories>(this))
 , _stickers(std::make_unique<Stickers>(this))
 , _reactions(std::make_unique<Reactions>(this))
@@ -2513,6 +2515,7 @@ void Session::unregisterMessage(not_null<HistoryItem*> item) {
 		item,
 		Data::MessageUpdate::Flag::Destroyed);
 	groups().unregisterMessage(item);
+	_messagesTextIndex->remove(item);
 	removeDependencyMessage(item);
 	for (auto i = begin(_highlightings); i != end(_highlightings);) {
 		if (i->second == item) {
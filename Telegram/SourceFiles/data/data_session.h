@@ -58,6 +58,7 @@ class ChatFilters;
 class CloudThemes;
 class Streaming;
 class MediaRotation;
+class MessagesTextIndex;
 class Histories;
 class DocumentMedia;
 class PhotoMedia;
@@ -122,6 +123,9 @@ public:
 	[[nodiscard]] MediaRotation &mediaRotation() const {
 		return *_mediaRotation;
 	}
+	[[nodiscard]] MessagesTextIndex &messagesTextIndex() const {
+		return *_messagesTextIndex;
+	}
 	[[nodiscard]] Histories &histories() const {
 		return *_histories;
 	}
@@ -1072,6 +1076,7 @@ private:
 	const std::unique_ptr<SendActionManager> _sendActionManager;
 	const std::unique_ptr<Streaming> _streaming;
 	const std::unique_ptr<MediaRotation> _mediaRotation;
+	const std::unique_ptr<MessagesTextIndex> _messagesTextIndex;
 	const std::unique_ptr<Histories> _histories;
 	const std::unique_ptr<Stickers> _stickers;
 	const std::unique_ptr<Reactions> _reactions;
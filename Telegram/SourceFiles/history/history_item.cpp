@@ -47,6 +47,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_scheduled_messages.h"
 #include "data/data_changes.h"
 #include "data/data_session.h"
+#include "data/data_messages_text_index.h"
 #include "data/data_message_reactions.h"
 #include "data/data_folder.h"
 #include "data/data_forum.h"
@@ -3058,6 +3059,7 @@ void HistoryItem::setTextValue(TextWithEntities text, bool force) {
 	const auto had = !_text.empty();
 	_text = std::move(text);
 	RemoveComponents(HistoryMessageTranslation::Bit());
+	history()->owner().messagesTextIndex().update(this);
 	if (had || force) {
 		history()->owner().requestItemTextRefresh(this);
 	}
@@ -276,6 +276,7 @@ public:
 	void setQuery(const QString &query);
 
 	[[nodiscard]] rpl::producer<SearchRequest> searchRequests() const;
+	[[nodiscard]] rpl::producer<SearchRequest> localSearchRequests() const;
 	[[nodiscard]] rpl::producer<PeerData*> fromValue() const;
 	[[nodiscard]] rpl::producer<> queryChanges() const;
 	[[nodiscard]] rpl::producer<> closeRequests() const;
@@ -311,6 +312,7 @@ private:
 	Api::MessagesSearchMerged::CachedRequests _typedRequests;
 
 	rpl::event_stream<SearchRequest> _searchRequests;
+	rpl::event_stream<SearchRequest> _localSearchRequests;
 	rpl::event_stream<> _queryChanges;
 	rpl::event_stream<> _cancelRequests;
 	rpl::event_stream<not_null<QKeyEvent*>> _keyEvents;
@@ -562,6 +564,7 @@ void TopBar::requestSearchDelayed() {
 		return;
 	}
 
+	_localSearchRequests.fire_copy(search);
 	_searchTimer.callOnce(AutoSearchTimeout);
 }
 
@@ -569,6 +572,10 @@ rpl::producer<SearchRequest> TopBar::searchRequests() const {
 	return _searchRequests.events();
 }
 
+rpl::producer<SearchRequest> TopBar::localSearchRequests() const {
+	return _localSearchRequests.events();
+}
+
 rpl::producer<> TopBar::queryChanges() const {
 	return _queryChanges.events();
 }
@@ -610,6 +617,7 @@ public:
 	BottomBar(not_null<Ui::RpWidget*> parent, bool fastShowChooseFrom);
 
 	void setTotal(int total);
+	void setLocalTotal(int total);
 	void setCurrent(int current);
 
 	[[nodiscard]] rpl::producer<Index> showItemRequests() const;
@@ -708,7 +716,7 @@ BottomBar::BottomBar(not_null<Ui::RpWidget*> parent, bool fastShowChooseFrom)
 
 	_current.value(
 	) | rpl::start_with_next([=](int current) {
-		const auto nextDisabled = (current <= 0) || (current >= _total);
+		const auto nextDisabled = (current < 0) || (current >= _total);
 		const auto prevDisabled = (current <= 1);
 		_next.enabled = !nextDisabled;
 		_previous.enabled = !prevDisabled;
@@ -770,6 +778,11 @@ void BottomBar::setTotal(int total) {
 	setCurrent(1);
 }
 
+void BottomBar::setLocalTotal(int total) {
+	_total = total;
+	_current.force_assign(0);
+}
+
 void BottomBar::setCurrent(int current) {
 	_current.force_assign(current);
 }
@@ -777,6 +790,11 @@ void BottomBar::setCurrent(int current) {
 void BottomBar::updateText(int current) {
 	if (_total < 0) {
 		_counter->setText(QString());
+	} else if (_total && !current) {
+		_counter->setText(tr::lng_search_found_results(
+			tr::now,
+			lt_count,
+			_total));
 	} else if (_total) {
 		_counter->setText(tr::lng_search_messages_n_of_amount(
 			tr::now,
@@ -790,7 +808,10 @@ void BottomBar::updateText(int current) {
 }
 
 rpl::producer<BottomBar::Index> BottomBar::showItemRequests() const {
-	return _current.changes() | rpl::map(rpl::mappers::_1 - 1);
+	return _current.changes(
+	) | rpl::filter(
+		rpl::mappers::_1 > 0
+	) | rpl::map(rpl::mappers::_1 - 1);
 }
 
 rpl::producer<> BottomBar::showCalendarRequests() const {
@@ -907,6 +928,11 @@ ComposeSearch::Inner::Inner(
 		_apiSearch.search(search);
 	}, _topBar->lifetime());
 
+	_topBar->localSearchRequests(
+	) | rpl::start_with_next([=](const SearchRequest &search) {
+		_apiSearch.searchLocal(search);
+	}, _topBar->lifetime());
+
 	_topBar->queryChanges(
 	) | rpl::start_with_next([=] {
 		hideList();
@@ -937,6 +963,14 @@ ComposeSearch::Inner::Inner(
 		}
 	}, _topBar->lifetime());
 
+	_apiSearch.localFounds(
+	) | rpl::start_with_next([=] {
+		// Instant results are only listed, the chat stays where it is.
+		const auto &apiData = _apiSearch.messages();
+		_bottomBar->setLocalTotal(apiData.total);
+		_list.controller->addItems(apiData.messages, true);
+	}, _topBar->lifetime());
+
 	_apiSearch.nextFounds(
 	) | rpl::start_with_next([=] {
 		if (_pendingJump.data.token == _apiSearch.messages().nextToken) {
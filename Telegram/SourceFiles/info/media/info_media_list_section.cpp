@@ -88,14 +88,58 @@ bool ListSection::belongsHere(
 	return _delegate->sectionItemBelongsHere(item, _items.back());
 }
 
+bool ListSection::isGrid() const {
+	return (_type == Type::Photo)
+		|| (_type == Type::Video)
+		|| (_type == Type::PhotoVideo)
+		|| (_type == Type::RoundFile);
+}
+
+int ListSection::gridTop() const {
+	return headerHeight() + _itemsTop;
+}
+
+int ListSection::gridRowHeight() const {
+	return _itemHeight + st::infoMediaSkip;
+}
+
+// First index in the row that ends below the top.
+int ListSection::gridIndexAfterTop(int top) const {
+	Expects(isGrid());
+
+	const auto from = top - gridTop() - _itemHeight;
+	const auto row = (from < 0) ? 0 : (from / gridRowHeight() + 1);
+	return std::min(row * _itemsInRow, int(_items.size()));
+}
+
+// First index in the row that starts at the bottom or below it.
+int ListSection::gridIndexAfterBottom(int bottom) const {
+	Expects(isGrid());
+
+	const auto rowHeight = gridRowHeight();
+	const auto from = bottom - gridTop();
+	const auto row = (from <= 0) ? 0 : ((from + rowHeight - 1) / rowHeight);
+	return std::min(row * _itemsInRow, int(_items.size()));
+}
+
 void ListSection::appendItem(not_null<BaseLayout*> item) {
+	if (isGrid()) {
+		// Grid cells are placed by index, see findItemRect().
+		item->setPosition(int(_items.size()));
+	}
 	_items.push_back(item);
 	_byItem.emplace(item->getItem(), item);
 }
 
 bool ListSection::removeItem(not_null<const HistoryItem*> item) {
 	if (const auto i = _byItem.find(item); i != end(_byItem)) {
-		_items.erase(ranges::remove(_items, i->second), end(_items));
+		const auto j = ranges::find(_items, i->second);
+		if (isGrid()) {
+			for (auto k = j + 1; k != end(_items); ++k) {
+				(*k)->setPosition((*k)->position() - 1);
+			}
+		}
+		_items.erase(j);
 		_byItem.erase(i);
 		refreshHeight();
 		return true;
@@ -105,15 +149,18 @@ bool ListSection::removeItem(not_null<const HistoryItem*> item) {
 
 QRect ListSection::findItemRect(
 		not_null<const BaseLayout*> item) const {
-	auto position = item->position();
+	const auto position = item->position();
 	if (!_mosaic.empty()) {
 		return _mosaic.findRect(position);
+	} else if (!isGrid()) {
+		return QRect(_itemsLeft, position, _itemWidth, item->height());
 	}
-	auto top = position / _itemsInRow;
-	auto indexInRow = position % _itemsInRow;
-	auto left = _itemsLeft
+	const auto row = position / _itemsInRow;
+	const auto indexInRow = position % _itemsInRow;
+	const auto left = _itemsLeft
 		+ indexInRow * (_itemWidth + st::infoMediaSkip);
-	return QRect(left, top, _itemWidth, item->height());
+	const auto top = gridTop() + row * gridRowHeight();
+	return QRect(left, top, _itemWidth, _itemHeight);
 }
 
 ListFoundItem ListSection::completeResult(
@@ -174,13 +221,15 @@ auto ListSection::findItemAfterTop(
 		int top) -> Items::iterator {
 	Expects(_mosaic.empty());
 
+	if (isGrid()) {
+		return begin(_items) + gridIndexAfterTop(top);
+	}
 	return ranges::lower_bound(
 		_items,
 		top,
 		std::less_equal<>(),
-		[this](const auto &item) {
-			const auto itemTop = item->position() / _itemsInRow;
-			return itemTop + item->height();
+		[](const auto &item) {
+			return item->position() + item->height();
 		});
 }
 
@@ -188,13 +237,15 @@ auto ListSection::findItemAfterTop(
 		int top) const -> Items::const_iterator {
 	Expects(_mosaic.empty());
 
+	if (isGrid()) {
+		return begin(_items) + gridIndexAfterTop(top);
+	}
 	return ranges::lower_bound(
 		_items,
 		top,
 		std::less_equal<>(),
-		[this](const auto &item) {
-			const auto itemTop = item->position() / _itemsInRow;
-			return itemTop + item->height();
+		[](const auto &item) {
+			return item->position() + item->height();
 		});
 }
 
@@ -202,14 +253,18 @@ auto ListSection::findItemAfterBottom(
 		Items::const_iterator from,
 		int bottom) const -> Items::const_iterator {
 	Expects(_mosaic.empty());
+
+	if (isGrid()) {
+		const auto index = gridIndexAfterBottom(bottom);
+		return std::max(from, begin(_items) + index);
+	}
 	return ranges::lower_bound(
 		from,
 		_items.end(),
 		bottom,
 		std::less<>(),
-		[this](const auto &item) {
-			const auto itemTop = item->position() / _itemsInRow;
-			return itemTop;
+		[](const auto &item) {
+			return item->position();
 		});
 }
 
@@ -382,22 +437,10 @@ int ListSection::recountHeight() {
 	case Type::Video:
 	case Type::PhotoVideo:
 	case Type::RoundFile: {
-		auto itemHeight = _itemHeight + st::infoMediaSkip;
-		auto index = 0;
-		result += _itemsTop;
-		for (auto &item : _items) {
-			item->setPosition(_itemsInRow * result + index);
-			if (++index == _itemsInRow) {
-				result += itemHeight;
-				index = 0;
-			}
-		}
-		if (_items.size() % _itemsInRow) {
-			_rowsCount = int(_items.size()) / _itemsInRow + 1;
-			result += itemHeight;
-		} else {
-			_rowsCount = int(_items.size()) / _itemsInRow;
-		}
+		// Cells are placed by index, so nothing is stored in the items.
+		const auto count = int(_items.size());
+		_rowsCount = (count + _itemsInRow - 1) / _itemsInRow;
+		result += _itemsTop + _rowsCount * gridRowHeight();
 	} break;
 
 	case Type::GIF: {
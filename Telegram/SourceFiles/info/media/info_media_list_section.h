@@ -54,6 +54,11 @@ private:
 	void appendItem(not_null<BaseLayout*> item);
 	void setHeader(not_null<BaseLayout*> item);
 	[[nodiscard]] bool belongsHere(not_null<BaseLayout*> item) const;
+	[[nodiscard]] bool isGrid() const;
+	[[nodiscard]] int gridTop() const;
+	[[nodiscard]] int gridRowHeight() const;
+	[[nodiscard]] int gridIndexAfterTop(int top) const;
+	[[nodiscard]] int gridIndexAfterBottom(int bottom) const;
 	[[nodiscard]] Items::iterator findItemAfterTop(int top);
 	[[nodiscard]] Items::const_iterator findItemAfterTop(int top) const;
 	[[nodiscard]] Items::const_iterator findItemAfterBottom(
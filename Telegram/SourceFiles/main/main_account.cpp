@@ -269,12 +269,19 @@ QByteArray Account::serializeMtpAuthorization() const {
 	const auto serialize = [&](
 			MTP::DcId mainDcId,
 			const MTP::AuthKeysList &keys,
-			const MTP::AuthKeysList &keysToDestroy) {
-		const auto keysSize = [](auto &list) {
-			const auto keyDataSize = MTP::AuthKey::Data().size();
+			const MTP::AuthKeysList &keysToDestroy,
+			const MTP::BoundTemporaryKeysList &temporaryKeys) {
+		const auto keyDataSize = MTP::AuthKey::Data().size();
+		const auto keysSize = [&](auto &list) {
 			return sizeof(qint32)
 				+ list.size() * (sizeof(qint32) + keyDataSize);
 		};
+		const auto temporaryKeysSize = [&](auto &list) {
+			// dcId + mediaCluster + persistentKeyId + expiresAt + data
+			return sizeof(qint32) + list.size() * (3 * sizeof(qint32)
+				+ sizeof(quint64)
+				+ keyDataSize);
+		};
 		const auto writeKeys = [](
 				QDataStream &stream,
 				const MTP::AuthKeysList &keys) {
@@ -284,11 +291,25 @@ QByteArray Account::serializeMtpAuthorization() const {
 				key->write(stream);
 			}
 		};
+		const auto writeTemporaryKeys = [](
+				QDataStream &stream,
+				const MTP::BoundTemporaryKeysList &keys) {
+			stream << qint32(keys.size());
+			for (const auto &[key, persistentKeyId, mediaCluster] : keys) {
+				stream
+					<< qint32(key->dcId())
+					<< qint32(mediaCluster ? 1 : 0)
+					<< quint64(persistentKeyId)
+					<< qint32(key->expiresAt());
+				key->write(stream);
+			}
+		};
 
 		auto result = QByteArray();
 		// wide tag + userId + mainDcId
 		auto size = 2 * sizeof(quint64) + sizeof(qint32);
 		size += keysSize(keys) + keysSize(keysToDestroy);
+		size += temporaryKeysSize(temporaryKeys);
 		result.reserve(size);
 		{
 			QDataStream stream(&result, QIODevice::WriteOnly);
@@ -303,6 +324,7 @@ QByteArray Account::serializeMtpAuthorization() const {
 				<< qint32(mainDcId);
 			writeKeys(stream, keys);
 			writeKeys(stream, keysToDestroy);
+			writeTemporaryKeys(stream, temporaryKeys);
 
 			DEBUG_LOG(("MTP Info: Keys written, userId: %1, dcId: %2"
 				).arg(currentUserId.bare
@@ -315,11 +337,21 @@ QByteArray Account::serializeMtpAuthorization() const {
 		const auto keysToDestroy = _mtpForKeysDestroy
 			? _mtpForKeysDestroy->getKeysForWrite()
 			: MTP::AuthKeysList();
-		return serialize(_mtp->mainDcId(), keys, keysToDestroy);
+		const auto temporaryKeys = _mtp->getTemporaryKeysForWrite();
+		return serialize(
+			_mtp->mainDcId(),
+			keys,
+			keysToDestroy,
+			temporaryKeys);
 	}
 	const auto &keys = _mtpFields.keys;
 	const auto &keysToDestroy = _mtpKeysToDestroy;
-	return serialize(_mtpFields.mainDcId, keys, keysToDestroy);
+	const auto &temporaryKeys = _mtpFields.temporaryKeys;
+	return serialize(
+		_mtpFields.mainDcId,
+		keys,
+		keysToDestroy,
+		temporaryKeys);
 }
 
 void Account::setSessionUserId(UserId userId) {
@@ -399,12 +431,47 @@ void Account::setMtpAuthorization(const QByteArray &serialized) {
 			keys.push_back(std::make_shared<MTP::AuthKey>(MTP::AuthKey::Type::ReadFromFile, dcId, keyData));
 		}
 	};
+	const auto readTemporaryKeys = [&](auto &keys) {
+		const auto count = Serialize::read<qint32>(stream);
+		if (stream.status() != QDataStream::Ok) {
+			LOG(("MTP Error: "
+				"Could not read temporary keys count "
+				"from mtp authorization."));
+			return;
+		}
+		keys.reserve(count);
+		for (auto i = 0; i != count; ++i) {
+			const auto dcId = Serialize::read<qint32>(stream);
+			const auto mediaCluster = Serialize::read<qint32>(stream);
+			const auto persistentKeyId = Serialize::read<quint64>(stream);
+			const auto expiresAt = Serialize::read<qint32>(stream);
+			const auto keyData = Serialize::read<MTP::AuthKey::Data>(stream);
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("MTP Error: "
+					"Could not read temporary key from mtp authorization."));
+				keys.clear();
+				return;
+			}
+			keys.push_back({
+				.key = MTP::AuthKey::RestoreTemporary(
+					dcId,
+					keyData,
+					expiresAt),
+				.persistentKeyId = persistentKeyId,
+				.mediaCluster = (mediaCluster == 1),
+			});
+		}
+	};
 	readKeys(_mtpFields.keys);
 	readKeys(_mtpKeysToDestroy);
+	if (!stream.atEnd()) {
+		readTemporaryKeys(_mtpFields.temporaryKeys);
+	}
 	LOG(("MTP Info: "
-		"read keys, current: %1, to destroy: %2"
+		"read keys, current: %1, to destroy: %2, temporary: %3"
 		).arg(_mtpFields.keys.size()
-		).arg(_mtpKeysToDestroy.size()));
+		).arg(_mtpKeysToDestroy.size()
+		).arg(_mtpFields.temporaryKeys.size()));
 }
 
 void Account::startMtp(std::unique_ptr<MTP::Config> config) {
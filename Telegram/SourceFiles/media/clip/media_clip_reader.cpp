@@ -33,9 +33,134 @@ namespace Media {
 namespace Clip {
 namespace {
 
-constexpr auto kClipThreadsCount = 8;
+constexpr auto kClipThreadsMin = 2;
+constexpr auto kClipThreadsMax = 8;
 constexpr auto kAverageGifSize = 320 * 240;
 constexpr auto kWaitBeforeGifPause = crl::time(200);
+constexpr auto kMissedDeadlineDelay = crl::time(20);
+
+[[nodiscard]] int ClipThreadsLimit() {
+	static const auto result = std::clamp(
+		QThread::idealThreadCount(),
+		kClipThreadsMin,
+		kClipThreadsMax);
+	return result;
+}
+
+// Same rounding as Qt's BYTE_MUL, so the result matches QPainter output.
+[[nodiscard]] inline uint32 ByteMul(uint32 x, uint32 a) {
+	auto t = (((uint64(x)) | (uint64(x) << 24)) & 0x00FF00FF00FF00FFULL) * a;
+	t = (t + ((t >> 8) & 0x00FF00FF00FF00FFULL) + 0x0080008000800080ULL) >> 8;
+	t &= 0x00FF00FF00FF00FFULL;
+	return uint32(t) | uint32(t >> 24);
+}
+
+[[nodiscard]] inline uint32 SourceOver(uint32 src, uint32 dst) {
+	const auto alpha = (src >> 24);
+	return (alpha == 0xFF)
+		? src
+		: !alpha
+		? dst
+		: (src + ByteMul(dst, 0xFF - alpha));
+}
+
+void FillLine(uint32 *to, int count, uint32 color) {
+	if ((color >> 24) == 0xFF) {
+		std::fill_n(to, count, color);
+	} else {
+		for (const auto till = to + count; to != till; ++to) {
+			*to = SourceOver(color, *to);
+		}
+	}
+}
+
+// Letterboxes and composes an unscaled frame straight into the cache bits,
+// doing in one pass per line what the QPainter path does in several.
+[[nodiscard]] bool PrepareFrameFast(
+		const FrameRequest &request,
+		const QImage &original,
+		bool hasAlpha,
+		QImage &cache,
+		bool needNewCache) {
+	const auto format = original.format();
+	if (original.size() != request.frame
+		|| (format != QImage::Format_ARGB32_Premultiplied
+			&& format != QImage::Format_RGB32)
+		|| cache.format() != QImage::Format_ARGB32_Premultiplied) {
+		return false;
+	}
+	const auto factor = request.factor;
+	const auto outerw = cache.width();
+	const auto outerh = cache.height();
+	const auto framew = request.frame.width();
+	const auto frameh = request.frame.height();
+	const auto left = ((outerw - framew) / (2 * factor)) * factor;
+	const auto top = ((outerh - frameh) / (2 * factor)) * factor;
+	const auto fromx = std::max(left, 0);
+	const auto tillx = std::min(left + framew, outerw);
+	const auto fromy = std::max(top, 0);
+	const auto tilly = std::min(top + frameh, outerh);
+	if (fromx >= tillx || fromy >= tilly) {
+		return false;
+	}
+	// With kept alpha the QPainter path clears the whole cache first.
+	const auto clearOuter = hasAlpha && request.keepAlpha;
+	const auto fillOuter = clearOuter
+		|| (needNewCache && (framew < outerw || frameh < outerh));
+	const auto background = clearOuter
+		? uint32()
+		: fillOuter
+		? qPremultiply(st::imageBg->c.rgba())
+		: uint32();
+	const auto fill = [&](uint32 *to, int count) {
+		if (clearOuter) {
+			std::fill_n(to, count, background);
+		} else {
+			FillLine(to, count, background);
+		}
+	};
+	const auto underlay = (hasAlpha && !request.keepAlpha)
+		? qPremultiply(st::imageBgTransparent->c.rgba())
+		: uint32();
+	const auto copy = !hasAlpha
+		|| request.keepAlpha
+		|| (format == QImage::Format_RGB32);
+	const auto cachePerLine = cache.bytesPerLine();
+	const auto originalPerLine = original.bytesPerLine();
+	auto bytes = cache.bits();
+	auto source = original.constBits()
+		+ (fromy - top) * originalPerLine
+		+ (fromx - left) * 4;
+	for (auto y = 0; y != outerh; ++y, bytes += cachePerLine) {
+		const auto line = reinterpret_cast<uint32*>(bytes);
+		if (y < fromy || y >= tilly) {
+			if (fillOuter) {
+				fill(line, outerw);
+			}
+			continue;
+		}
+		if (fillOuter) {
+			fill(line, fromx);
+			fill(line + tillx, outerw - tillx);
+		}
+		const auto from = reinterpret_cast<const uint32*>(source);
+		const auto to = line + fromx;
+		const auto count = tillx - fromx;
+		if (copy && format == QImage::Format_RGB32) {
+			for (auto x = 0; x != count; ++x) {
+				to[x] = from[x] | 0xFF000000U;
+			}
+		} else if (copy) {
+			memcpy(to, from, count * 4);
+		} else {
+			for (auto x = 0; x != count; ++x) {
+				to[x] = SourceOver(from[x], SourceOver(underlay, to[x]));
+			}
+		}
+		source += originalPerLine;
+	}
+	return true;
+}
 
 QImage PrepareFrame(
 		const FrameRequest &request,
@@ -62,10 +187,10 @@ QImage PrepareFrame(
 		cache = QImage(size, QImage::Format_ARGB32_Premultiplied);
 		cache.setDevicePixelRatio(factor);
 	}
-	if (hasAlpha && request.keepAlpha) {
-		cache.fill(Qt::transparent);
-	}
-	{
+	if (!PrepareFrameFast(request, original, hasAlpha, cache, needNewCache)) {
+		if (hasAlpha && request.keepAlpha) {
+			cache.fill(Qt::transparent);
+		}
 		auto p = QPainter(&cache);
 		const auto framew = request.frame.width();
 		const auto outerw = size.width();
@@ -127,6 +252,15 @@ public:
 	int loadLevel() const {
 		return _loadLevel;
 	}
+	int readersCount() const {
+		return _readersCount.loadAcquire();
+	}
+	int queueDepth() const {
+		return _queueDepth.loadAcquire();
+	}
+	int missedDeadlines() const {
+		return _missedDeadlines.loadAcquire();
+	}
 	void append(Reader *reader, const Core::FileLocation &location, const QByteArray &data);
 	void start(Reader *reader);
 	void update(Reader *reader);
@@ -140,6 +274,9 @@ private:
 	void clear();
 
 	QAtomicInt _loadLevel;
+	QAtomicInt _readersCount;
+	QAtomicInt _queueDepth;
+	QAtomicInt _missedDeadlines;
 	using ReaderPointers = QMap<Reader*, QAtomicInt>;
 	ReaderPointers _readerPointers;
 	mutable QMutex _readerPointersMutex;
@@ -203,19 +340,20 @@ Reader::Reader(const QByteArray &data, Callback &&callback)
 }
 
 void Reader::init(const Core::FileLocation &location, const QByteArray &data) {
-	if (Workers.size() < kClipThreadsCount) {
+	// Prefer an idle or the least loaded existing thread,
+	// start a new one only if all of them are already busy.
+	auto loadLevel = 0x7FFFFFFF;
+	_threadIndex = Workers.empty() ? 0 : base::RandomIndex(Workers.size());
+	for (int i = 0, l = int(Workers.size()); i < l; ++i) {
+		const auto level = Workers[i]->manager.loadLevel();
+		if (level < loadLevel) {
+			_threadIndex = i;
+			loadLevel = level;
+		}
+	}
+	if (loadLevel > 0 && int(Workers.size()) < ClipThreadsLimit()) {
 		_threadIndex = Workers.size();
 		Workers.push_back(std::make_unique<Worker>());
-	} else {
-		_threadIndex = base::RandomIndex(Workers.size());
-		auto loadLevel = 0x7FFFFFFF;
-		for (int i = 0, l = int(Workers.size()); i < l; ++i) {
-			const auto level = Workers[i]->manager.loadLevel();
-			if (level < loadLevel) {
-				_threadIndex = i;
-				loadLevel = level;
-			}
-		}
 	}
 	Workers[_threadIndex]->manager.append(this, location, data);
 }
@@ -704,6 +842,7 @@ Manager::Manager(not_null<QThread*> thread) {
 void Manager::append(Reader *reader, const Core::FileLocation &location, const QByteArray &data) {
 	reader->_private = new ReaderPrivate(reader, location, data);
 	_loadLevel.fetchAndAddRelaxed(kAverageGifSize);
+	_readersCount.fetchAndAddRelaxed(1);
 	update(reader);
 }
 
@@ -827,6 +966,7 @@ bool Manager::handleProcessResult(ReaderPrivate *reader, ProcessResult result, c
 Manager::ResultHandleState Manager::handleResult(ReaderPrivate *reader, ProcessResult result, crl::time ms) {
 	if (!handleProcessResult(reader, result, ms)) {
 		_loadLevel.fetchAndAddRelaxed(-1 * (reader->_width > 0 ? reader->_width * reader->_height : kAverageGifSize));
+		_readersCount.fetchAndAddRelaxed(-1);
 		delete reader;
 		return ResultHandleRemove;
 	}
@@ -837,6 +977,9 @@ Manager::ResultHandleState Manager::handleResult(ReaderPrivate *reader, ProcessR
 	}
 
 	if (result == ProcessResult::Repaint) {
+		if (reader->_nextFrameWhen + kMissedDeadlineDelay < ms) {
+			_missedDeadlines.fetchAndAddRelaxed(1);
+		}
 		{
 			QMutexLocker lock(&_readerPointersMutex);
 			auto it = constUnsafeFindReaderPointer(reader);
@@ -894,30 +1037,48 @@ void Manager::process() {
 		checkAllReaders = (_readers.size() > _readerPointers.size());
 	}
 
+	// Handle the readers with the earliest deadlines first,
+	// so that a heavy clip doesn't delay all the others on this thread.
+	auto due = std::vector<std::pair<crl::time, ReaderPrivate*>>();
+	for (auto i = _readers.begin(), e = _readers.end(); i != e; ++i) {
+		if (i.value() <= ms) {
+			due.emplace_back(i.key()->_nextFrameWhen, i.key());
+		}
+	}
+	ranges::sort(due);
+	_queueDepth.storeRelease(int(due.size()));
+
+	for (const auto &[when, reader] : due) {
+		ResultHandleState state = handleResult(reader, reader->process(ms), ms);
+		if (state == ResultHandleRemove) {
+			_readers.remove(reader);
+			_queueDepth.fetchAndAddRelaxed(-1);
+			continue;
+		} else if (state == ResultHandleStop) {
+			_processingInThread = nullptr;
+			return;
+		}
+		const auto i = _readers.find(reader);
+		Assert(i != _readers.end());
+		ms = crl::now();
+		if (reader->_videoPausedAtMs) {
+			i.value() = ms + 86400 * 1000ULL;
+		} else if (reader->_nextFrameWhen && reader->_started) {
+			i.value() = reader->_nextFrameWhen;
+		} else {
+			i.value() = (ms + 86400 * 1000ULL);
+		}
+		_queueDepth.fetchAndAddRelaxed(-1);
+	}
+
 	for (auto i = _readers.begin(), e = _readers.end(); i != e;) {
 		ReaderPrivate *reader = i.key();
-		if (i.value() <= ms) {
-			ResultHandleState state = handleResult(reader, reader->process(ms), ms);
-			if (state == ResultHandleRemove) {
-				i = _readers.erase(i);
-				continue;
-			} else if (state == ResultHandleStop) {
-				_processingInThread = nullptr;
-				return;
-			}
-			ms = crl::now();
-			if (reader->_videoPausedAtMs) {
-				i.value() = ms + 86400 * 1000ULL;
-			} else if (reader->_nextFrameWhen && reader->_started) {
-				i.value() = reader->_nextFrameWhen;
-			} else {
-				i.value() = (ms + 86400 * 1000ULL);
-			}
-		} else if (checkAllReaders) {
+		if (checkAllReaders) {
 			QMutexLocker lock(&_readerPointersMutex);
 			auto it = constUnsafeFindReaderPointer(reader);
 			if (it == _readerPointers.cend()) {
 				_loadLevel.fetchAndAddRelaxed(-1 * (reader->_width > 0 ? reader->_width * reader->_height : kAverageGifSize));
+				_readersCount.fetchAndAddRelaxed(-1);
 				delete reader;
 				i = _readers.erase(i);
 				continue;
@@ -958,6 +1119,8 @@ void Manager::clear() {
 		delete i.key();
 	}
 	_readers.clear();
+	_readersCount.storeRelease(0);
+	_queueDepth.storeRelease(0);
 }
 
 Manager::~Manager() {
@@ -1005,7 +1168,35 @@ Ui::PreparedFileInformation PrepareForSending(
 	return { .media = result };
 }
 
+namespace {
+
+struct SchedulerStats {
+	int threads = 0;
+	int readers = 0;
+	int queueDepth = 0;
+	int missedDeadlines = 0;
+};
+
+[[nodiscard]] SchedulerStats CollectSchedulerStats() {
+	auto result = SchedulerStats{ .threads = int(Workers.size()) };
+	for (const auto &worker : Workers) {
+		result.readers += worker->manager.readersCount();
+		result.queueDepth += worker->manager.queueDepth();
+		result.missedDeadlines += worker->manager.missedDeadlines();
+	}
+	return result;
+}
+
+} // namespace
+
 void Finish() {
+	const auto stats = CollectSchedulerStats();
+	DEBUG_LOG(("Clip Info: %1 threads, %2 readers, queue depth %3, "
+		"%4 missed frame deadlines."
+		).arg(stats.threads
+		).arg(stats.readers
+		).arg(stats.queueDepth
+		).arg(stats.missedDeadlines));
 	Workers.clear();
 }
 
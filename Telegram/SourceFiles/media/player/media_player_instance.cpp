@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/player/media_player_instance.h"
 
 #include "data/data_document.h"
+#include "data/data_document_media.h"
 #include "data/data_session.h"
 #include "data/data_changes.h"
 #include "data/data_streaming.h"
@@ -52,6 +53,9 @@ constexpr auto kRememberShuffledOrderItems = 16;
 
 constexpr auto kMinLengthForSavePosition = 20 * TimeId(60); // 20 minutes.
 
+// Start loading the next track when the current one is that close to end.
+constexpr auto kPreloadSeconds = 10;
+
 base::options::toggle OptionDisableAutoplayNext({
 	.id = kOptionDisableAutoplayNext,
 	.name = "Disable auto-play of the next track",
@@ -75,6 +79,12 @@ struct Instance::Streamed {
 	rpl::lifetime lifetime;
 };
 
+struct Instance::Preloaded {
+	AudioMsgId id;
+	std::shared_ptr<Streaming::Document> document;
+	std::shared_ptr<::Data::DocumentMedia> media;
+};
+
 struct Instance::ShuffleData {
 	using UniversalMsgId = MsgId;
 
@@ -333,6 +343,12 @@ void Instance::playlistUpdated(not_null<Data*> data) {
 		data->playlistIndex = std::nullopt;
 		data->shuffleData = nullptr;
 	}
+	if (data->preloaded) {
+		const auto item = itemToPreload(data);
+		if (!item || item->fullId() != data->preloaded->id.contextId()) {
+			data->preloaded = nullptr;
+		}
+	}
 	data->playlistChanges.fire({});
 }
 
@@ -583,6 +599,9 @@ bool Instance::moveInPlaylist(
 		: ((newIndex + int(data->playlistSlice->size()))
 			% int(data->playlistSlice->size()));
 	if (const auto item = itemByIndex(data, useIndex)) {
+		if (autonext) {
+			data->finishedAt = crl::now();
+		}
 		return jumpByItem(item);
 	} else if (repeatAll
 		&& data->playlistOtherSlice
@@ -597,6 +616,79 @@ bool Instance::moveInPlaylist(
 	return false;
 }
 
+HistoryItem *Instance::itemToPreload(not_null<Data*> data) {
+	if (!data->playlistIndex || order(data) == OrderMode::Shuffle) {
+		return nullptr;
+	}
+	const auto newIndex = *data->playlistIndex
+		+ (order(data) == OrderMode::Reverse ? -1 : 1);
+	const auto repeatAll = (repeat(data) == RepeatMode::All);
+	const auto useIndex = (!repeatAll
+		|| !data->playlistSlice
+		|| data->playlistSlice->skippedAfter() != 0
+		|| data->playlistSlice->skippedBefore() != 0
+		|| !data->playlistSlice->size())
+		? newIndex
+		: ((newIndex + int(data->playlistSlice->size()))
+			% int(data->playlistSlice->size()));
+	if (const auto item = itemByIndex(data, useIndex)) {
+		return item;
+	} else if (repeatAll
+		&& data->history
+		&& data->playlistOtherSlice
+		&& data->playlistOtherSlice->size() > 0) {
+		const auto &other = *data->playlistOtherSlice;
+		if (newIndex < 0 && other.skippedAfter() == 0) {
+			return data->history->owner().message(other[other.size() - 1]);
+		} else if (newIndex > 0 && other.skippedBefore() == 0) {
+			return data->history->owner().message(other[0]);
+		}
+	}
+	return nullptr;
+}
+
+void Instance::preloadNextIfNeeded(
+		not_null<Data*> data,
+		const TrackState &state) {
+	if (state.state != State::Playing
+		|| !state.frequency
+		|| state.length <= 0
+		|| repeat(data) == RepeatMode::One
+		|| OptionDisableAutoplayNext.value()) {
+		return;
+	}
+	const auto left = (state.length - state.position) * crl::time(1000)
+		/ state.frequency;
+	if (left > kPreloadSeconds * crl::time(1000)) {
+		return;
+	}
+	const auto item = itemToPreload(data);
+	const auto media = item ? item->media() : nullptr;
+	const auto document = media ? media->document() : nullptr;
+	if (!document
+		|| media->ttlSeconds()
+		|| !(document->isAudioFile()
+			|| document->isVoiceMessage()
+			|| document->isVideoMessage())) {
+		return;
+	}
+	const auto id = AudioMsgId(document, item->fullId());
+	if (data->preloaded && data->preloaded->id == id) {
+		return;
+	}
+
+	// Keep the streaming reader alive, so that its already loaded parts
+	// and opened header are reused when the track actually starts.
+	data->preloaded = std::make_unique<Preloaded>(Preloaded{
+		.id = id,
+		.document = document->owner().streaming().sharedDocument(
+			document,
+			item->fullId()),
+		.media = document->createMediaView(),
+	});
+	data->preloaded->media->automaticLoad(item->fullId(), item);
+}
+
 void Instance::updatePowerSaveBlocker(
 		not_null<Data*> data,
 		const TrackState &state) {
@@ -820,6 +912,7 @@ void Instance::playStreamed(
 	data->streamed = std::make_unique<Streamed>(
 		audioId,
 		std::move(shared));
+	data->preloaded = nullptr;
 	data->streamed->instance.lockPlayer();
 
 	data->streamed->instance.player().updates(
@@ -874,6 +967,7 @@ void Instance::stop(AudioMsgId::Type type) {
 		if (data->streamed) {
 			clearStreamed(data);
 		}
+		data->preloaded = nullptr;
 		data->resumeOnCallEnd = false;
 		_playerStopped.fire_copy({type});
 	}
@@ -1221,6 +1315,11 @@ void Instance::emitUpdate(AudioMsgId::Type type, CheckCallback check) {
 			}
 		}
 		updatePowerSaveBlocker(data, state);
+		preloadNextIfNeeded(data, state);
+		if (data->finishedAt && state.state == State::Playing) {
+			DEBUG_LOG(("Audio Info: Gap between tracks %1 ms."
+				).arg(crl::now() - base::take(data->finishedAt)));
+		}
 
 		auto finished = false;
 		_updatedNotifier.fire_copy({state});
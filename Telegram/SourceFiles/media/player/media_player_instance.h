@@ -168,6 +168,7 @@ private:
 	using SharedMediaType = Storage::SharedMediaType;
 	using SliceKey = SparseIdsMergedSlice::Key;
 	struct Streamed;
+	struct Preloaded;
 	struct ShuffleData;
 	struct Data {
 		Data(AudioMsgId::Type type, SharedMediaType overview);
@@ -195,7 +196,9 @@ private:
 		Main::Session *session = nullptr;
 		bool isPlaying = false;
 		bool resumeOnCallEnd = false;
+		crl::time finishedAt = 0;
 		std::unique_ptr<Streamed> streamed;
+		std::unique_ptr<Preloaded> preloaded;
 		std::unique_ptr<ShuffleData> shuffleData;
 		std::unique_ptr<base::PowerSaveBlocker> powerSaveBlocker;
 		std::unique_ptr<base::PowerSaveBlocker> powerSaveBlockerVideo;
@@ -238,6 +241,10 @@ private:
 	void validateOtherPlaylist(not_null<Data*> data);
 	void playlistUpdated(not_null<Data*> data);
 	bool moveInPlaylist(not_null<Data*> data, int delta, bool autonext);
+	HistoryItem *itemToPreload(not_null<Data*> data);
+	void preloadNextIfNeeded(
+		not_null<Data*> data,
+		const TrackState &state);
 	void updatePowerSaveBlocker(
 		not_null<Data*> data,
 		const TrackState &state);
@@ -24,7 +24,10 @@ static_assert(kDisplaySkipped != kTimeUnknown);
 
 [[nodiscard]] QImage ConvertToARGB32(
 		FrameFormat format,
-		const FrameYUV &data) {
+		const FrameYUV &data,
+		QSize resize,
+		QImage storage,
+		FFmpeg::SwscalePointer &swscale) {
 	Expects(data.y.data != nullptr);
 	Expects(data.u.data != nullptr);
 	Expects((format == FrameFormat::NV12) || (data.v.data != nullptr));
@@ -34,14 +37,20 @@ static_assert(kDisplaySkipped != kTimeUnknown);
 	//	resize.transpose();
 	//}
 
-	auto result = FFmpeg::CreateFrameStorage(data.size);
-	const auto swscale = FFmpeg::MakeSwscalePointer(
+	if (resize.isEmpty()) {
+		resize = data.size;
+	}
+	auto result = FFmpeg::GoodStorageForFrame(storage, resize)
+		? std::move(storage)
+		: FFmpeg::CreateFrameStorage(resize);
+	swscale = FFmpeg::MakeSwscalePointer(
 		data.size,
 		(format == FrameFormat::YUV420
 			? AV_PIX_FMT_YUV420P
 			: AV_PIX_FMT_NV12),
-		data.size,
-		AV_PIX_FMT_BGRA);
+		resize,
+		AV_PIX_FMT_BGRA,
+		&swscale);
 	if (!swscale) {
 		return QImage();
 	}
@@ -382,6 +391,7 @@ auto VideoTrackObject::readFrame(not_null<Frame*> frame) -> FrameResult {
 	std::swap(frame->transferred, _stream.transferredFrame);
 	frame->index = _frameIndex++;
 	frame->position = position;
+	frame->decodedAt = crl::now();
 	frame->displayed = kTimeUnknown;
 	return FrameResult::Done;
 }
@@ -472,10 +482,13 @@ void VideoTrackObject::rasterizeFrame(not_null<Frame*> frame) {
 			fail(Error::InvalidData);
 			return;
 		}
+		// Keep the storage for the main thread conversion to reuse.
 		if (!frame->original.isNull()) {
-			frame->original = QImage();
-			for (auto &[_, prepared] : frame->prepared) {
-				prepared.image = QImage();
+			frame->recycled = base::take(frame->original);
+		}
+		for (auto &[_, prepared] : frame->prepared) {
+			if (!prepared.image.isNull()) {
+				prepared.recycled = base::take(prepared.image);
 			}
 		}
 		frame->format = nv12 ? FrameFormat::NV12 : FrameFormat::YUV420;
@@ -486,12 +499,19 @@ void VideoTrackObject::rasterizeFrame(not_null<Frame*> frame) {
 			frameWithData->width,
 			frameWithData->height
 		};
+		if (frame->original.isNull()) {
+			frame->original = base::take(frame->recycled);
+		}
+		const auto storage = frame->original.constBits();
 		frame->original = ConvertFrame(
 			_stream,
 			frameWithData,
 			chooseOriginalResize(
 				{ frameWithData->width, frameWithData->height }),
 			std::move(frame->original));
+		if (frame->original.constBits() != storage) {
+			_shared->countAllocation();
+		}
 		if (frame->original.isNull()) {
 			frame->prepared.clear();
 			fail(Error::InvalidData);
@@ -968,6 +988,12 @@ crl::time VideoTrack::Shared::markFrameDisplayed(crl::time now) {
 		Assert(frame->position != kTimeUnknown);
 		if (frame->displayed == kTimeUnknown) {
 			frame->displayed = now;
+			if (frame->decodedAt != kTimeUnknown) {
+				const auto latency = now - frame->decodedAt;
+				++_statistics.framesShown;
+				_statistics.latencySum += latency;
+				accumulate_max(_statistics.latencyMax, latency);
+			}
 		}
 		return frame->position;
 	};
@@ -1043,6 +1069,16 @@ bool VideoTrack::Shared::markFrameShown() {
 	Unexpected("Counter value in VideoTrack::Shared::markFrameShown.");
 }
 
+void VideoTrack::Shared::countAllocation() {
+	_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+VideoTrack::Statistics VideoTrack::Shared::statistics() const {
+	auto result = _statistics;
+	result.allocations = _allocations.load(std::memory_order_relaxed);
+	return result;
+}
+
 not_null<VideoTrack::Frame*> VideoTrack::Shared::frameForPaint() {
 	return frameForPaintWithIndex().frame;
 }
@@ -1214,7 +1250,38 @@ QImage VideoTrack::frameImage(
 	if (frame->original.isNull()
 		&& (frame->format == FrameFormat::YUV420
 			|| frame->format == FrameFormat::NV12)) {
-		frame->original = ConvertToARGB32(frame->format, frame->yuv);
+		// If nobody else paints this frame, convert it straight
+		// to the requested size instead of scaling it once more.
+		// The full size original is still converted on demand.
+		const auto direct = !_streamRotation
+			&& !useRequest.blurredBackground
+			&& !useRequest.resize.isEmpty()
+			&& useRequest.resize == useRequest.outer
+			&& useRequest.rounding.empty()
+			&& useRequest.mask.isNull()
+			&& !useRequest.colored.alpha()
+			&& (frame->prepared.empty()
+				|| (frame->prepared.size() == 1 && !none));
+		if (direct) {
+			const auto j = none
+				? frame->prepared.emplace(instance, useRequest).first
+				: i;
+			j->second.request = useRequest;
+			if (changed || j->second.image.isNull()) {
+				auto storage = j->second.image.isNull()
+					? base::take(j->second.recycled)
+					: base::take(j->second.image);
+				j->second.image = convertToARGB32(
+					frame,
+					useRequest.resize,
+					std::move(storage));
+			}
+			return j->second.image;
+		}
+		frame->original = convertToARGB32(
+			frame,
+			QSize(),
+			base::take(frame->recycled));
 	}
 	if (GoodForRequest(
 			frame->original,
@@ -1255,11 +1322,31 @@ QImage VideoTrack::currentFrameImage() {
 	if (frame->original.isNull()
 		&& (frame->format == FrameFormat::YUV420
 			|| frame->format == FrameFormat::NV12)) {
-		frame->original = ConvertToARGB32(frame->format, frame->yuv);
+		frame->original = convertToARGB32(
+			frame,
+			QSize(),
+			base::take(frame->recycled));
 	}
 	return frame->original;
 }
 
+QImage VideoTrack::convertToARGB32(
+		not_null<Frame*> frame,
+		QSize resize,
+		QImage storage) {
+	const auto bits = storage.constBits();
+	auto result = ConvertToARGB32(
+		frame->format,
+		frame->yuv,
+		resize,
+		std::move(storage),
+		_swscale);
+	if (!result.isNull() && result.constBits() != bits) {
+		_shared->countAllocation();
+	}
+	return result;
+}
+
 void VideoTrack::unregisterInstance(not_null<const Instance*> instance) {
 	_wrapped.with([=](Implementation &unwrapped) {
 		unwrapped.removeFrameRequest(instance);
@@ -1337,6 +1424,16 @@ rpl::producer<> VideoTrack::waitingForData() const {
 }
 
 VideoTrack::~VideoTrack() {
+	const auto statistics = _shared->statistics();
+	if (statistics.framesShown > 0) {
+		DEBUG_LOG(("Video Info: %1 frames shown, "
+			"decode-to-present latency %2 ms average, %3 ms max, "
+			"%4 frame allocations."
+			).arg(statistics.framesShown
+			).arg(statistics.latencySum / statistics.framesShown
+			).arg(statistics.latencyMax
+			).arg(statistics.allocations));
+	}
 	_wrapped.with([shared = std::move(_shared)](Implementation &unwrapped) {
 		unwrapped.interrupt();
 	});
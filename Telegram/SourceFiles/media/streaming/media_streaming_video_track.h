@@ -73,19 +73,28 @@ public:
 private:
 	friend class VideoTrackObject;
 
+	struct Statistics {
+		int framesShown = 0;
+		int allocations = 0;
+		crl::time latencySum = 0;
+		crl::time latencyMax = 0;
+	};
 	struct Prepared {
 		Prepared(const FrameRequest &request) : request(request) {
 		}
 
 		FrameRequest request = FrameRequest::NonStrict();
 		QImage image;
+		QImage recycled;
 	};
 	struct Frame {
 		FFmpeg::FramePointer decoded = FFmpeg::MakeFramePointer();
 		FFmpeg::FramePointer transferred;
 		QImage original;
+		QImage recycled;
 		FrameYUV yuv;
 		crl::time position = kTimeUnknown;
+		crl::time decodedAt = kTimeUnknown;
 		crl::time displayed = kTimeUnknown;
 		crl::time display = kTimeUnknown;
 		FrameFormat format = FrameFormat::None;
@@ -138,6 +147,10 @@ private:
 		[[nodiscard]] not_null<Frame*> frameForPaint();
 		[[nodiscard]] FrameWithIndex frameForPaintWithIndex();
 
+		// Allocations are counted from both threads.
+		void countAllocation();
+		[[nodiscard]] Statistics statistics() const;
+
 	private:
 		[[nodiscard]] not_null<Frame*> getFrame(int index);
 		[[nodiscard]] not_null<const Frame*> getFrame(int index) const;
@@ -153,6 +166,9 @@ private:
 		// (_counter % 2) == 0 crl::queue can read _delay.
 		crl::time _delay = kTimeUnknown;
 
+		std::atomic<int> _allocations = 0;
+		Statistics _statistics;
+
 	};
 
 	static void PrepareFrameByRequests(
@@ -169,6 +185,10 @@ private:
 		not_null<Frame*> frame,
 		const FrameRequest &request,
 		const Instance *instance);
+	[[nodiscard]] QImage convertToARGB32(
+		not_null<Frame*> frame,
+		QSize resize,
+		QImage storage);
 
 	const int _streamIndex = 0;
 	const AVRational _streamTimeBase;
@@ -176,6 +196,7 @@ private:
 	const int _streamRotation = 0;
 	const AVRational _streamAspect = FFmpeg::kNormalAspect;
 	std::unique_ptr<Shared> _shared;
+	FFmpeg::SwscalePointer _swscale;
 
 	using Implementation = VideoTrackObject;
 	crl::object_on_queue<Implementation> _wrapped;
@@ -14,6 +14,19 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "styles/style_media_view.h"
 
 namespace Media::View {
+namespace {
+
+// Smaller images are scaled fast enough while painting.
+constexpr auto kMipmapMinArea = 3000 * 3000;
+constexpr auto kMipmapMinSide = 1024;
+
+} // namespace
+
+struct OverlayWidget::RendererSW::Mipmaps {
+	qint64 cacheKey = 0;
+	std::vector<QImage> levels; // Each is half the size of the previous.
+	bool ready = false;
+};
 
 OverlayWidget::RendererSW::RendererSW(not_null<OverlayWidget*> owner)
 : _owner(owner)
@@ -112,11 +125,66 @@ void OverlayWidget::RendererSW::paintTransformedStaticContent(
 		_p->fillRect(rect, _transparentBrush);
 	}
 	if (!image.isNull()) {
-		paintTransformedImage(image, rect, rotation);
+		const auto &source = index ? image : chooseMipmap(image, rect);
+		paintTransformedImage(source, rect, rotation);
 	}
 	paintControlsFade(rect, geometry);
 }
 
+const QImage &OverlayWidget::RendererSW::chooseMipmap(
+		const QImage &image,
+		QRect rect) {
+	if (image.width() * image.height() < kMipmapMinArea) {
+		return image;
+	} else if (!_mipmaps || _mipmaps->cacheKey != image.cacheKey()) {
+		// Build the levels once per image on a worker thread, until then
+		// the zoomed out photo is painted from the full image directly.
+		const auto mipmaps = std::make_shared<Mipmaps>();
+		mipmaps->cacheKey = image.cacheKey();
+		_mipmaps = mipmaps;
+		const auto weak = std::weak_ptr<Mipmaps>(mipmaps);
+		const auto owner = _owner;
+		crl::async([=, image = image] {
+			auto levels = std::vector<QImage>();
+			auto previous = image;
+			while (std::max(previous.width(), previous.height()) / 2
+				>= kMipmapMinSide) {
+				previous = previous.scaled(
+					previous.size() / 2,
+					Qt::IgnoreAspectRatio,
+					Qt::SmoothTransformation);
+				levels.push_back(previous);
+			}
+			crl::on_main([=, levels = std::move(levels)]() mutable {
+				if (const auto strong = weak.lock()) {
+					strong->levels = std::move(levels);
+					strong->ready = true;
+					owner->update();
+				}
+			});
+		});
+		return image;
+	} else if (!_mipmaps->ready) {
+		return image;
+	}
+
+	// Use the smallest level that is still not upscaled on screen.
+	const auto shown = std::max(rect.width(), rect.height())
+		* style::DevicePixelRatio();
+	const auto &levels = _mipmaps->levels;
+	const auto side = [](const QImage &image) {
+		return std::max(image.width(), image.height());
+	};
+	auto result = &image;
+	for (const auto &level : levels) {
+		if (side(level) < shown) {
+			break;
+		}
+		result = &level;
+	}
+	return *result;
+}
+
 void OverlayWidget::RendererSW::paintControlsFade(
 		QRect content,
 		const ContentGeometry &geometry) {
@@ -61,6 +61,11 @@ private:
 
 	bool handleHideWorkaround();
 	void validateOverControlImage();
+	[[nodiscard]] const QImage &chooseMipmap(
+		const QImage &image,
+		QRect rect);
+
+	struct Mipmaps;
 
 	[[nodiscard]] static QRect TransformRect(QRectF geometry, int rotation);
 
@@ -76,6 +81,8 @@ private:
 	QImage _topShadowCache;
 	QColor _topShadowColor;
 
+	std::shared_ptr<Mipmaps> _mipmaps;
+
 };
 
 } // namespace Media::View
@@ -58,6 +58,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_user.h"
 #include "data/data_media_rotation.h"
 #include "data/data_photo_media.h"
+#include "data/data_streaming.h"
 #include "data/data_document_media.h"
 #include "data/data_document_resolver.h"
 #include "data/data_file_click_handler.h"
@@ -102,6 +103,8 @@ namespace View {
 namespace {
 
 constexpr auto kPreloadCount = 3;
+constexpr auto kPrefetchBytesLimit = 96 * 1024 * 1024;
+constexpr auto kPrefetchVideoFrames = 4;
 constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
@@ -219,6 +222,12 @@ QWidget *PipDelegate::pipParentWidget() {
 	return false;
 }
 
+// A paused player keeps its decoded frames queue filled.
+[[nodiscard]] int64 PrefetchVideoBytes(not_null<DocumentData*> document) {
+	const auto size = document->dimensions;
+	return int64(size.width()) * size.height() * 4 * kPrefetchVideoFrames;
+}
+
 } // namespace
 
 struct OverlayWidget::SharedMedia {
@@ -4495,6 +4504,16 @@ void OverlayWidget::validatePhotoImage(Image *image, bool blurred) {
 	}
 	const auto use = flipSizeByRotation({ _width, _height })
 		* style::DevicePixelRatio();
+	if (!blurred && _photo) {
+		const auto i = _prefetchedPhotos.find(_photo);
+		if (i != end(_prefetchedPhotos)
+			&& i->second.cacheKey == image->original().cacheKey()
+			&& i->second.image.size() == use) {
+			setStaticContent(i->second.image);
+			_blurred = false;
+			return;
+		}
+	}
 	setStaticContent(image->pixNoCache(
 		use,
 		{ .options = (blurred ? Images::Option::Blur : Images::Option()) }
@@ -5422,6 +5441,7 @@ void OverlayWidget::setSession(not_null<Main::Session*> session) {
 		if (!isHidden()) {
 			updateControls();
 			checkForSaveLoaded();
+			prefetchPreloadedPhotos();
 		}
 	}, _sessionLifetime);
 
@@ -5495,6 +5515,7 @@ void OverlayWidget::preloadData(int delta) {
 
 	auto photos = base::flat_set<std::shared_ptr<Data::PhotoMedia>>();
 	auto documents = base::flat_set<std::shared_ptr<Data::DocumentMedia>>();
+	auto videos = base::flat_map<not_null<DocumentData*>, Data::FileOrigin>();
 	for (auto index = from; index != till + 1; ++index) {
 		auto entity = entityByIndex(index);
 		if (auto photo = std::get_if<not_null<PhotoData*>>(&entity.data)) {
@@ -5508,11 +5529,128 @@ void OverlayWidget::preloadData(int delta) {
 			(*i)->thumbnailWanted(fileOrigin(entity));
 			if (!(*i)->canBePlayed(entity.item)) {
 				(*i)->automaticLoad(fileOrigin(entity), entity.item);
+			} else if ((*document)->isVideoFile()
+				&& std::abs(index - *_index) == 1) {
+				videos.emplace(*document, fileOrigin(entity));
 			}
 		}
 	}
 	_preloadPhotos = std::move(photos);
 	_preloadDocuments = std::move(documents);
+	prefetchPreloadedVideos(videos);
+	prefetchPreloadedPhotos();
+}
+
+int64 OverlayWidget::prefetchedBytes() const {
+	auto result = int64();
+	for (const auto &[photo, prefetched] : _prefetchedPhotos) {
+		result += prefetched.bytes;
+	}
+	for (const auto &[document, instance] : _prefetchedVideos) {
+		result += PrefetchVideoBytes(document);
+	}
+	return result;
+}
+
+void OverlayWidget::prefetchPreloadedVideos(
+		const base::flat_map<
+			not_null<DocumentData*>,
+			Data::FileOrigin> &videos) {
+	for (auto i = begin(_prefetchedVideos); i != end(_prefetchedVideos);) {
+		const auto document = i->first;
+		if (document != _document && videos.contains(document)) {
+			++i;
+			continue;
+		}
+		// The video may be opened right now, don't lose its reader.
+		document->owner().streaming().keepAlive(document);
+		i = _prefetchedVideos.erase(i);
+	}
+	auto bytes = prefetchedBytes();
+	for (const auto &[document, origin] : videos) {
+		const auto size = PrefetchVideoBytes(document);
+		if (document == _document
+			|| _prefetchedVideos.contains(document)
+			|| !size
+			|| bytes + size > kPrefetchBytesLimit) {
+			continue;
+		}
+		auto instance = std::make_unique<Streaming::Instance>(
+			document,
+			origin,
+			nullptr);
+		if (!instance->valid() || instance->player().active()) {
+			// Someone else already plays it, nothing to open in advance.
+			continue;
+		}
+
+		// Open the file and decode the first frame, but don't start it.
+		// The overlay will restart it from the reader that keeps
+		// the header and the first frame parts.
+		instance->play({
+			.mode = Streaming::Mode::Video,
+			.hwAllowed = Core::App().settings().hardwareAcceleratedVideo(),
+		});
+		instance->pause();
+		bytes += size;
+		_prefetchedVideos.emplace(document, std::move(instance));
+	}
+}
+
+void OverlayWidget::prefetchPreloadedPhotos() {
+	for (auto i = begin(_prefetchedPhotos); i != end(_prefetchedPhotos);) {
+		const auto photo = i->first;
+		const auto preloaded = (photo == _photo) || ranges::contains(
+			_preloadPhotos,
+			photo,
+			&Data::PhotoMedia::owner);
+		if (!preloaded) {
+			i = _prefetchedPhotos.erase(i);
+		} else {
+			++i;
+		}
+	}
+
+	// Pending photos are counted by the size they will take when ready.
+	auto bytes = prefetchedBytes();
+	const auto ratio = style::DevicePixelRatio();
+	for (const auto &media : _preloadPhotos) {
+		const auto photo = media->owner();
+		const auto large = media->image(Data::PhotoSize::Large);
+		if (photo == _photo || !large) {
+			continue;
+		}
+		const auto original = large->original();
+		const auto i = _prefetchedPhotos.find(photo);
+		if (i != end(_prefetchedPhotos)
+			&& i->second.cacheKey == original.cacheKey()) {
+			continue;
+		}
+
+		// The same size validatePhotoImage() will ask for this photo.
+		const auto use = style::ConvertScale(
+			QSize(photo->width(), photo->height())) * ratio;
+		const auto size = int64(use.width()) * use.height() * 4;
+		if (use.isEmpty() || bytes + size > kPrefetchBytesLimit) {
+			continue;
+		}
+		bytes += size;
+		_prefetchedPhotos[photo] = {
+			.cacheKey = original.cacheKey(),
+			.bytes = size,
+		};
+		const auto weak = Ui::MakeWeak(_widget);
+		crl::async([=] {
+			auto prepared = Images::Prepare(original, use, {});
+			crl::on_main(weak, [=, image = std::move(prepared)]() mutable {
+				const auto i = _prefetchedPhotos.find(photo);
+				if (i != end(_prefetchedPhotos)
+					&& i->second.cacheKey == original.cacheKey()) {
+					i->second.image = std::move(image);
+				}
+			});
+		});
+	}
 }
 
 void OverlayWidget::handleMousePress(
@@ -6172,6 +6310,8 @@ void OverlayWidget::clearBeforeHide() {
 	assignMediaPointer(nullptr);
 	_preloadPhotos.clear();
 	_preloadDocuments.clear();
+	_prefetchedPhotos.clear();
+	_prefetchedVideos.clear();
 	if (_menu) {
 		_menu->hideMenu(true);
 	}
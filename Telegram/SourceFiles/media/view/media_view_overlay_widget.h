@@ -64,6 +64,7 @@ struct TrackState;
 } // namespace Media::Player
 
 namespace Media::Streaming {
+class Instance;
 struct Information;
 struct Update;
 struct FrameWithInfo;
@@ -308,6 +309,12 @@ private:
 	void updateGeometryToScreen(bool inMove = false);
 	bool moveToNext(int delta);
 	void preloadData(int delta);
+	void prefetchPreloadedPhotos();
+	void prefetchPreloadedVideos(
+		const base::flat_map<
+			not_null<DocumentData*>,
+			Data::FileOrigin> &videos);
+	[[nodiscard]] int64 prefetchedBytes() const;
 
 	void handleScreenChanged(QScreen *screen);
 
@@ -556,6 +563,15 @@ private:
 	std::shared_ptr<Data::DocumentMedia> _documentMedia;
 	base::flat_set<std::shared_ptr<Data::PhotoMedia>> _preloadPhotos;
 	base::flat_set<std::shared_ptr<Data::DocumentMedia>> _preloadDocuments;
+	struct PrefetchedPhoto {
+		qint64 cacheKey = 0;
+		QImage image;
+		int64 bytes = 0;
+	};
+	base::flat_map<not_null<PhotoData*>, PrefetchedPhoto> _prefetchedPhotos;
+	base::flat_map<
+		not_null<DocumentData*>,
+		std::unique_ptr<Streaming::Instance>> _prefetchedVideos;
 	int _rotation = 0;
 	std::unique_ptr<SharedMedia> _sharedMedia;
 	std::optional<SharedMediaWithLastSlice> _sharedMediaData;
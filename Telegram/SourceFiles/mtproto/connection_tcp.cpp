@@ -23,6 +23,42 @@ constexpr auto kSmallBufferSize = 256 * 1024;
 constexpr auto kMinPacketBuffer = 256;
 constexpr auto kConnectionStartPrefixSize = 64;
 
+#ifdef TDESKTOP_NETWORK_EMULATION
+struct NetworkEmulation {
+	crl::time delay = 0;
+	float64 disconnect = 0.;
+};
+
+// Built only with the TDESKTOP_NETWORK_EMULATION option, allows measuring
+// the transport against a local server loaded with the 'endpoints' code, f.e. TDESKTOP_NETWORK_EMULATION=delay=300,disconnect=0.01
+// delays each received packet by 300 ms and drops the connection on 1%.
+[[nodiscard]] const NetworkEmulation &Emulation() {
+	static const auto result = [] {
+		auto result = NetworkEmulation();
+		const auto value = qEnvironmentVariable("TDESKTOP_NETWORK_EMULATION");
+		for (const auto &part : value.split(',', Qt::SkipEmptyParts)) {
+			const auto pair = part.split('=');
+			if (pair.size() != 2) {
+				continue;
+			}
+			const auto key = pair[0].trimmed();
+			if (key == u"delay"_q) {
+				result.delay = std::max(pair[1].toLongLong(), 0LL);
+			} else if (key == u"disconnect"_q) {
+				result.disconnect = std::clamp(pair[1].toDouble(), 0., 1.);
+			}
+		}
+		if (result.delay || result.disconnect > 0.) {
+			LOG(("TCP Info: emulating network, delay %1 ms, disconnect %2."
+				).arg(result.delay
+				).arg(result.disconnect));
+		}
+		return result;
+	}();
+	return result;
+}
+#endif // TDESKTOP_NETWORK_EMULATION
+
 } // namespace
 
 class TcpConnection::Protocol {
@@ -250,7 +286,11 @@ TcpConnection::TcpConnection(
 	const ProxyData &proxy)
 : AbstractConnection(thread, proxy)
 , _instance(instance)
-, _checkNonce(base::RandomValue<MTPint128>()) {
+, _checkNonce(base::RandomValue<MTPint128>())
+#ifdef TDESKTOP_NETWORK_EMULATION
+, _delayedPacketsTimer(thread, [=] { handleDelayedPackets(); })
+#endif // TDESKTOP_NETWORK_EMULATION
+{
 }
 
 ConnectionPointer TcpConnection::clone(const ProxyData &proxy) {
@@ -501,6 +541,10 @@ void TcpConnection::disconnectFromServer() {
 	_connectedLifetime.destroy();
 	_lifetime.destroy();
 	_socket = nullptr;
+#ifdef TDESKTOP_NETWORK_EMULATION
+	_delayedPackets.clear();
+	_delayedPacketsTimer.cancel();
+#endif // TDESKTOP_NETWORK_EMULATION
 }
 
 void TcpConnection::connectToServer(
@@ -585,8 +629,37 @@ crl::time TcpConnection::fullConnectTimeout() const {
 void TcpConnection::socketPacket(bytes::const_span bytes) {
 	Expects(_socket != nullptr);
 
+#ifdef TDESKTOP_NETWORK_EMULATION
+	if (const auto delay = Emulation().delay) {
+		_delayedPackets.push_back({ crl::now() + delay, parsePacket(bytes) });
+		if (!_delayedPacketsTimer.isActive()) {
+			_delayedPacketsTimer.callOnce(delay);
+		}
+		return;
+	}
+#endif // TDESKTOP_NETWORK_EMULATION
+	handlePacket(parsePacket(bytes));
+}
+
+#ifdef TDESKTOP_NETWORK_EMULATION
+void TcpConnection::handleDelayedPackets() {
+	const auto now = crl::now();
+	while (!_delayedPackets.empty() && _delayedPackets.front().when <= now) {
+		const auto data = std::move(_delayedPackets.front().data);
+		_delayedPackets.pop_front();
+		handlePacket(data);
+		if (!_socket) {
+			return;
+		}
+	}
+	if (!_delayedPackets.empty()) {
+		_delayedPacketsTimer.callOnce(_delayedPackets.front().when - now);
+	}
+}
+#endif // TDESKTOP_NETWORK_EMULATION
+
+void TcpConnection::handlePacket(const mtpBuffer &data) {
 	// old quickack?..
-	const auto data = parsePacket(bytes);
 	if (data.size() == 1) {
 		if (data[0] != 0) {
 			error(data[0]);
@@ -596,6 +669,15 @@ void TcpConnection::socketPacket(bytes::const_span bytes) {
 	//} else if (data.size() == 2) {
 		// new quickack?..
 	} else if (_status == Status::Ready) {
+#ifdef TDESKTOP_NETWORK_EMULATION
+		const auto disconnect = Emulation().disconnect;
+		if (disconnect > 0.
+			&& base::RandomValue<uint32>() < disconnect * 0xFFFFFFFFU) {
+			CONNECTION_LOG_INFO("Emulating a connection loss.");
+			error(kErrorCodeOther);
+			return;
+		}
+#endif // TDESKTOP_NETWORK_EMULATION
 		_receivedQueue.push_back(data);
 		receivedData();
 	} else if (_status == Status::Waiting) {
@@ -10,6 +10,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/connection_abstract.h"
 #include "mtproto/mtproto_auth_key.h"
 
+#ifdef TDESKTOP_NETWORK_EMULATION
+#include "base/timer.h"
+
+#include <deque>
+#endif // TDESKTOP_NETWORK_EMULATION
+
 namespace MTP {
 namespace details {
 
@@ -55,6 +61,10 @@ private:
 	bytes::const_span prepareConnectionStartPrefix(bytes::span buffer);
 
 	void socketPacket(bytes::const_span bytes);
+	void handlePacket(const mtpBuffer &data);
+#ifdef TDESKTOP_NETWORK_EMULATION
+	void handleDelayedPackets();
+#endif // TDESKTOP_NETWORK_EMULATION
 
 	void socketConnected();
 	void socketDisconnected();
@@ -93,6 +103,15 @@ private:
 	int32 _port = 0;
 	crl::time _pingTime = 0;
 
+#ifdef TDESKTOP_NETWORK_EMULATION
+	struct DelayedPacket {
+		crl::time when = 0;
+		mtpBuffer data;
+	};
+	std::deque<DelayedPacket> _delayedPackets;
+	base::Timer _delayedPacketsTimer;
+#endif // TDESKTOP_NETWORK_EMULATION
+
 	rpl::lifetime _connectedLifetime;
 	rpl::lifetime _lifetime;
 
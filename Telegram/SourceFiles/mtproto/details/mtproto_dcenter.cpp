@@ -96,6 +96,52 @@ bool Dcenter::destroyConfirmedForgottenKey(uint64 keyId) {
 	return true;
 }
 
+BoundTemporaryKeysList Dcenter::getBoundTemporaryKeys() const {
+	QReadLocker lock(&_mutex);
+	auto result = BoundTemporaryKeysList();
+	if (!_persistentKey) {
+		return result;
+	}
+	const auto types = {
+		TemporaryKeyType::Regular,
+		TemporaryKeyType::MediaCluster,
+	};
+	for (const auto type : types) {
+		if (const auto &key = _temporaryKeys[IndexByType(type)]) {
+			result.push_back({
+				.key = key,
+				.persistentKeyId = _persistentKey->keyId(),
+				.mediaCluster = (type == TemporaryKeyType::MediaCluster),
+			});
+		}
+	}
+	return result;
+}
+
+bool Dcenter::restoreBoundTemporaryKey(const BoundTemporaryKey &data) {
+	Expects(data.key != nullptr);
+
+	const auto index = IndexByType(data.mediaCluster
+		? TemporaryKeyType::MediaCluster
+		: TemporaryKeyType::Regular);
+
+	QWriteLocker lock(&_mutex);
+	if (!_persistentKey
+		|| _persistentKey->keyId() != data.persistentKeyId
+		|| _temporaryKeys[index]
+		|| _creatingKeys[index]) {
+		return false;
+	}
+	_temporaryKeys[index] = data.key;
+	_connectionInited = false;
+
+	DEBUG_LOG(("AuthKey Info: Dcenter::restoreBoundTemporaryKey(%1, %2, %3)."
+		).arg(data.mediaCluster ? "media" : "regular"
+		).arg(data.key->keyId()
+		).arg(data.persistentKeyId));
+	return true;
+}
+
 bool Dcenter::connectionInited() const {
 	QReadLocker lock(&_mutex);
 	return _connectionInited;
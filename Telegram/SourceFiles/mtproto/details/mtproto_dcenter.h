@@ -14,6 +14,8 @@ namespace MTP {
 class Instance;
 class AuthKey;
 using AuthKeyPtr = std::shared_ptr<AuthKey>;
+struct BoundTemporaryKey;
+using BoundTemporaryKeysList = std::vector<BoundTemporaryKey>;
 enum class DcType;
 
 namespace details {
@@ -50,6 +52,11 @@ public:
 	bool destroyTemporaryKey(uint64 keyId);
 	bool destroyConfirmedForgottenKey(uint64 keyId);
 
+	// Temporary keys are saved together with the persistent key they were
+	// bound to, so that they could be reused instead of a new DH exchange.
+	[[nodiscard]] BoundTemporaryKeysList getBoundTemporaryKeys() const;
+	bool restoreBoundTemporaryKey(const BoundTemporaryKey &data);
+
 	[[nodiscard]] bool connectionInited() const;
 	void setConnectionInited(bool connectionInited = true);
 
@@ -0,0 +1,152 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_rpc_stats.h"
+
+#include <bit>
+
+namespace MTP::details {
+
+void RpcHistogram::add(int64 value) {
+	value = std::max(value, int64(0));
+	++_buckets[BucketIndex(value)];
+	++_count;
+	accumulate_max(_max, value);
+}
+
+int64 RpcHistogram::count() const {
+	return _count;
+}
+
+int64 RpcHistogram::percentile(float64 part) const {
+	if (!_count) {
+		return 0;
+	}
+	const auto wanted = std::clamp(
+		int64(std::ceil(_count * part)),
+		int64(1),
+		_count);
+	auto passed = int64(0);
+	for (auto i = 0; i != kBuckets; ++i) {
+		passed += _buckets[i];
+		if (passed >= wanted) {
+			const auto upper = (i + 1 < kBuckets)
+				? (BucketValue(i + 1) - 1)
+				: _max;
+			return std::min(upper, _max);
+		}
+	}
+	return _max;
+}
+
+int64 RpcHistogram::max() const {
+	return _max;
+}
+
+int RpcHistogram::BucketIndex(int64 value) {
+	if (value < kSubBuckets) {
+		return int(value);
+	}
+	const auto power = std::min(
+		int(std::bit_width(uint64(value))) - 1,
+		kMaxPower);
+	const auto shift = power - kSubBucketsPower;
+	const auto sub = (power < kMaxPower)
+		? int((value >> shift) & (kSubBuckets - 1))
+		: (kSubBuckets - 1);
+	return kSubBuckets + shift * kSubBuckets + sub;
+}
+
+int64 RpcHistogram::BucketValue(int index) {
+	if (index < kSubBuckets) {
+		return index;
+	}
+	const auto shift = (index - kSubBuckets) / kSubBuckets;
+	const auto sub = (index - kSubBuckets) % kSubBuckets;
+	return int64(kSubBuckets + sub) << shift;
+}
+
+void RpcStats::sent(
+		mtpRequestId requestId,
+		mtpTypeId type,
+		ShiftedDcId shiftedDcId,
+		int bytes) {
+	const auto key = Key{ type, BareDcId(shiftedDcId) };
+
+	QMutexLocker lock(&_mutex);
+	auto &entry = _entries[key];
+	++entry.requests;
+	entry.bytesSent += bytes;
+	_pending[requestId] = Pending{ key, crl::now() };
+}
+
+void RpcStats::received(
+		mtpRequestId requestId,
+		int bytes,
+		crl::time firstSentTime,
+		crl::time receivedAt) {
+	QMutexLocker lock(&_mutex);
+	const auto i = _pending.find(requestId);
+	if (i == end(_pending)) {
+		return;
+	}
+	const auto pending = i->second;
+	_pending.erase(i);
+
+	auto &entry = _entries[pending.key];
+	++entry.responses;
+	entry.bytesReceived += bytes;
+	if (firstSentTime) {
+		entry.queued.add(firstSentTime - pending.created);
+		if (receivedAt) {
+			entry.roundTrip.add(receivedAt - firstSentTime);
+		}
+	}
+}
+
+void RpcStats::forget(mtpRequestId requestId) {
+	QMutexLocker lock(&_mutex);
+	_pending.remove(requestId);
+}
+
+QString RpcStats::dump(int limit) const {
+	QMutexLocker lock(&_mutex);
+	auto sorted = std::vector<std::pair<Key, const Entry*>>();
+	sorted.reserve(_entries.size());
+	for (const auto &[key, entry] : _entries) {
+		sorted.emplace_back(key, &entry);
+	}
+	ranges::sort(sorted, ranges::greater(), [](const auto &pair) {
+		return pair.second->bytesSent + pair.second->bytesReceived;
+	});
+	if (limit > 0 && int(sorted.size()) > limit) {
+		sorted.resize(limit);
+	}
+	auto lines = QStringList();
+	lines.reserve(sorted.size());
+	for (const auto &[key, entry] : sorted) {
+		lines.push_back(QString("dc %1, type %2: "
+			"%3 requests, %4 responses, %5 bytes sent, %6 bytes received, "
+			"queued p50 %7 p99 %8 ms, "
+			"rtt p50 %9 p90 %10 p99 %11 max %12 ms"
+		).arg(key.dcId
+		).arg(key.type, 0, 16
+		).arg(entry->requests
+		).arg(entry->responses
+		).arg(entry->bytesSent
+		).arg(entry->bytesReceived
+		).arg(entry->queued.percentile(0.5)
+		).arg(entry->queued.percentile(0.99)
+		).arg(entry->roundTrip.percentile(0.5)
+		).arg(entry->roundTrip.percentile(0.9)
+		).arg(entry->roundTrip.percentile(0.99)
+		).arg(entry->roundTrip.max()));
+	}
+	return lines.join('\n');
+}
+
+} // namespace MTP::details
@@ -0,0 +1,86 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "mtproto/core_types.h"
+#include "base/flat_map.h"
+
+#include <QtCore/QMutex>
+
+namespace MTP::details {
+
+// Log-linear buckets, eight per power of two, so that any percentile
+// is reported with at most 12.5% error, like in HDR histograms.
+class RpcHistogram final {
+public:
+	void add(int64 value);
+
+	[[nodiscard]] int64 count() const;
+	[[nodiscard]] int64 percentile(float64 part) const;
+	[[nodiscard]] int64 max() const;
+
+private:
+	static constexpr auto kSubBucketsPower = 3;
+	static constexpr auto kSubBuckets = (1 << kSubBucketsPower);
+	static constexpr auto kMaxPower = 31;
+	static constexpr auto kBuckets = kSubBuckets
+		* (kMaxPower - kSubBucketsPower + 2);
+
+	[[nodiscard]] static int BucketIndex(int64 value);
+	[[nodiscard]] static int64 BucketValue(int index);
+
+	std::array<uint32, kBuckets> _buckets = { { 0 } };
+	int64 _count = 0;
+	int64 _max = 0;
+
+};
+
+class RpcStats final {
+public:
+	// Thread safe.
+	void sent(
+		mtpRequestId requestId,
+		mtpTypeId type,
+		ShiftedDcId shiftedDcId,
+		int bytes);
+	void received(
+		mtpRequestId requestId,
+		int bytes,
+		crl::time firstSentTime,
+		crl::time receivedAt);
+	void forget(mtpRequestId requestId);
+
+	[[nodiscard]] QString dump(int limit) const;
+
+private:
+	struct Key {
+		mtpTypeId type = 0;
+		DcId dcId = 0;
+
+		friend inline auto operator<=>(Key, Key) = default;
+	};
+	struct Pending {
+		Key key;
+		crl::time created = 0;
+	};
+	struct Entry {
+		int64 requests = 0;
+		int64 responses = 0;
+		int64 bytesSent = 0;
+		int64 bytesReceived = 0;
+		RpcHistogram queued;
+		RpcHistogram roundTrip;
+	};
+
+	mutable QMutex _mutex;
+	base::flat_map<mtpRequestId, Pending> _pending;
+	base::flat_map<Key, Entry> _entries;
+
+};
+
+} // namespace MTP::details
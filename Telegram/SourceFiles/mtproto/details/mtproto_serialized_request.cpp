@@ -35,6 +35,36 @@ uint32 CountPaddingPrimesCount(
 
 } // namespace
 
+RequestPriority PriorityByType(mtpTypeId type) {
+	switch (type) {
+	case mtpc_messages_sendMessage:
+	case mtpc_messages_sendMedia:
+	case mtpc_messages_sendMultiMedia:
+	case mtpc_messages_forwardMessages:
+	case mtpc_messages_editMessage:
+	case mtpc_messages_deleteMessages:
+	case mtpc_channels_deleteMessages:
+	case mtpc_messages_readHistory:
+	case mtpc_channels_readHistory:
+	case mtpc_messages_readMessageContents:
+	case mtpc_messages_setTyping:
+	case mtpc_messages_sendReaction:
+		return RequestPriority::Interactive;
+
+	case mtpc_messages_getStickerSet:
+	case mtpc_messages_getAllStickers:
+	case mtpc_messages_getFeaturedStickers:
+	case mtpc_messages_getEmojiKeywords:
+	case mtpc_messages_getEmojiKeywordsDifference:
+	case mtpc_channels_getFullChannel:
+	case mtpc_stats_getBroadcastStats:
+	case mtpc_stats_getMegagroupStats:
+	case mtpc_stats_loadAsyncGraph:
+		return RequestPriority::Background;
+	}
+	return RequestPriority::Regular;
+}
+
 SerializedRequest::SerializedRequest(const RequestConstructHider::Tag &tag)
 : _data(std::make_shared<RequestData>(tag)) {
 }
@@ -17,6 +17,15 @@ namespace details {
 class RequestData;
 class SerializedRequest;
 
+enum class RequestPriority : uchar {
+	Interactive,
+	Regular,
+	Background,
+};
+inline constexpr auto kRequestPrioritiesCount = 3;
+
+[[nodiscard]] RequestPriority PriorityByType(mtpTypeId type);
+
 class RequestConstructHider {
 	struct Tag {};
 	friend class RequestData;
@@ -89,7 +98,9 @@ public:
 
 	SerializedRequest after;
 	crl::time lastSentTime = 0;
+	crl::time firstSentTime = 0;
 	mtpRequestId requestId = 0;
+	RequestPriority priority = RequestPriority::Regular;
 	bool needsLayer = false;
 	bool forceSendInContainer = false;
 
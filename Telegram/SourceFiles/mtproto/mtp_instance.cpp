@@ -9,10 +9,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "mtproto/details/mtproto_dcenter.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
+#include "mtproto/details/mtproto_rpc_stats.h"
 #include "mtproto/special_config_request.h"
 #include "mtproto/session.h"
 #include "mtproto/mtproto_config.h"
 #include "mtproto/mtproto_dc_options.h"
+#include "mtproto/mtproto_auth_key.h"
 #include "mtproto/config_loader.h"
 #include "mtproto/sender.h"
 #include "storage/localstorage.h"
@@ -28,16 +30,110 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/timer.h"
 #include "base/network_reachability.h"
 
+#include <zlib.h>
+
 namespace MTP {
 namespace {
 
 constexpr auto kConfigBecomesOldIn = 2 * 60 * crl::time(1000);
 constexpr auto kConfigBecomesOldForBlockedIn = 8 * crl::time(1000);
 
+// Don't reuse a saved temporary key if it expires sooner than that.
+constexpr auto kTemporaryKeyMinimalLifetime = TimeId(3600);
+
+// Requests larger than that are sent as gzip_packed, if it helps enough.
+constexpr auto kGzipMinimalSize = 1024;
+constexpr auto kGzipMinimalRatio = 0.9;
+constexpr auto kGzipEntropySample = 4096;
+constexpr auto kGzipMaximalEntropy = 7.2; // Bits per byte.
+
+constexpr auto kRpcStatsLogPeriod = 600 * crl::time(1000);
+constexpr auto kRpcStatsLogLimit = 20;
+
 using namespace details;
 
 std::atomic<int> GlobalAtomicRequestId = 0;
 
+[[nodiscard]] bool LooksCompressible(bytes::const_span data) {
+	auto counts = std::array<int, 256>();
+	const auto sample = data.subspan(
+		0,
+		std::min(int(data.size()), kGzipEntropySample));
+	for (const auto byte : sample) {
+		++counts[uchar(byte)];
+	}
+	auto entropy = 0.;
+	const auto total = float64(sample.size());
+	for (const auto count : counts) {
+		if (count) {
+			const auto probability = count / total;
+			entropy -= probability * std::log2(probability);
+		}
+	}
+	return (entropy < kGzipMaximalEntropy);
+}
+
+[[nodiscard]] QByteArray Gzip(bytes::const_span data) {
+	auto stream = z_stream();
+	const auto init = deflateInit2(
+		&stream,
+		Z_DEFAULT_COMPRESSION,
+		Z_DEFLATED,
+		16 + MAX_WBITS,
+		8,
+		Z_DEFAULT_STRATEGY);
+	if (init != Z_OK) {
+		LOG(("MTP Error: could not init zlib deflate stream, code: %1"
+			).arg(init));
+		return QByteArray();
+	}
+	auto result = QByteArray(deflateBound(&stream, data.size()), 0);
+	stream.avail_in = data.size();
+	stream.next_in = reinterpret_cast<Bytef*>(
+		const_cast<bytes::type*>(data.data()));
+	stream.avail_out = result.size();
+	stream.next_out = reinterpret_cast<Bytef*>(result.data());
+	const auto res = deflate(&stream, Z_FINISH);
+	deflateEnd(&stream);
+	if (res != Z_STREAM_END) {
+		LOG(("MTP Error: could not gzip request, code: %1").arg(res));
+		return QByteArray();
+	}
+	result.resize(result.size() - stream.avail_out);
+	return result;
+}
+
+// Returns an empty request if compression doesn't make sense.
+[[nodiscard]] SerializedRequest GzipPacked(const SerializedRequest &request) {
+	const auto length = tl::count_length(request);
+	if (length < kGzipMinimalSize) {
+		return SerializedRequest();
+	}
+	const auto from = request->constData()
+		+ SerializedRequest::kMessageBodyPosition;
+	switch (mtpTypeId(*from)) {
+	case mtpc_gzip_packed:
+	case mtpc_upload_saveFilePart:
+	case mtpc_upload_saveBigFilePart: return SerializedRequest();
+	}
+	const auto body = bytes::make_span(
+		reinterpret_cast<const bytes::type*>(from),
+		length);
+	if (!LooksCompressible(body)) {
+		return SerializedRequest();
+	}
+	const auto packed = Gzip(body);
+	if (packed.isEmpty() || packed.size() > length * kGzipMinimalRatio) {
+		return SerializedRequest();
+	}
+	const auto wrapped = MTP_bytes(packed);
+	auto result = SerializedRequest::Prepare(
+		1 + (tl::count_length(wrapped) >> 2));
+	result->push_back(mtpc_gzip_packed);
+	wrapped.write<mtpBuffer>(*result);
+	return result;
+}
+
 } // namespace
 
 namespace details {
@@ -81,6 +177,7 @@ public:
 	void dcTemporaryKeyChanged(DcId dcId);
 	[[nodiscard]] rpl::producer<DcId> dcTemporaryKeyChanged() const;
 	[[nodiscard]] AuthKeysList getKeysForWrite() const;
+	[[nodiscard]] BoundTemporaryKeysList getTemporaryKeysForWrite() const;
 	void addKeysForDestroy(AuthKeysList &&keys);
 	[[nodiscard]] rpl::producer<> allKeysDestroyed() const;
 
@@ -176,6 +273,8 @@ public:
 
 	void prepareToDestroy();
 
+	[[nodiscard]] QString rpcStats() const;
+
 	[[nodiscard]] rpl::lifetime &lifetime();
 
 private:
@@ -191,6 +290,8 @@ private:
 
 	void unpaused();
 
+	void restoreTemporaryKeys(BoundTemporaryKeysList &&keys);
+
 	Session *findSession(ShiftedDcId shiftedDcId);
 	not_null<Session*> startSession(ShiftedDcId shiftedDcId);
 	void scheduleSessionDestroy(ShiftedDcId shiftedDcId);
@@ -252,6 +353,15 @@ private:
 	base::flat_map<DcId, AuthKeyPtr> _keysForWrite;
 	base::flat_map<ShiftedDcId, mtpRequestId> _logoutGuestRequestIds;
 
+	struct GzipStats {
+		int64 count = 0;
+		int64 original = 0;
+		int64 packed = 0;
+	};
+	base::flat_map<mtpTypeId, GzipStats> _gzipStats;
+	RpcStats _rpcStats;
+	base::Timer _rpcStatsTimer;
+
 	rpl::event_stream<> _writeKeysRequests;
 	rpl::event_stream<> _allKeysDestroyed;
 
@@ -352,6 +462,9 @@ Instance::Private::Private(
 		_keysForWrite[shiftedDcId] = key;
 		addDc(shiftedDcId, std::move(key));
 	}
+	if (!isKeysDestroyer()) {
+		restoreTemporaryKeys(std::move(fields.temporaryKeys));
+	}
 
 	if (fields.mainDcId != Fields::kNotSetMainDc) {
 		_mainDcId = fields.mainDcId;
@@ -377,6 +490,14 @@ void Instance::Private::start() {
 
 	_checkDelayedTimer.setCallback([this] { checkDelayedRequests(); });
 
+	_rpcStatsTimer.setCallback([=] {
+		const auto stats = _rpcStats.dump(kRpcStatsLogLimit);
+		if (!stats.isEmpty()) {
+			LOG(("MTP Info: rpc stats by traffic:\n%1").arg(stats));
+		}
+	});
+	_rpcStatsTimer.callEach(kRpcStatsLogPeriod);
+
 	Assert(!hasMainDcId() == isKeysDestroyer());
 	requestConfig();
 }
@@ -823,6 +944,36 @@ void Instance::Private::dcPersistentKeyChanged(
 
 void Instance::Private::dcTemporaryKeyChanged(DcId dcId) {
 	_dcTemporaryKeyChanged.fire_copy(dcId);
+
+	if (!isKeysDestroyer()
+		&& !isTemporaryDcId(dcId)
+		&& _keysForWrite.contains(dcId)) {
+		DEBUG_LOG(("AuthKey Info: writing auth keys, "
+			"temporary key changed in dc %1").arg(dcId));
+		_writeKeysRequests.fire({});
+	}
+}
+
+void Instance::Private::restoreTemporaryKeys(BoundTemporaryKeysList &&keys) {
+	if (keys.empty()) {
+		return;
+	}
+	const auto now = base::unixtime::now();
+	auto restored = 0;
+	for (const auto &data : keys) {
+		const auto dcId = data.key->dcId();
+		if (data.key->expiresAt() - now < kTemporaryKeyMinimalLifetime
+			|| !_keysForWrite.contains(dcId)) {
+			continue;
+		} else if (const auto dc = findDc(dcId)) {
+			if (dc->restoreBoundTemporaryKey(data)) {
+				++restored;
+			}
+		}
+	}
+	LOG(("MTP Info: restored temporary keys, %1 of %2."
+		).arg(restored
+		).arg(keys.size()));
 }
 
 rpl::producer<DcId> Instance::Private::dcTemporaryKeyChanged() const {
@@ -839,6 +990,24 @@ AuthKeysList Instance::Private::getKeysForWrite() const {
 	return result;
 }
 
+BoundTemporaryKeysList Instance::Private::getTemporaryKeysForWrite() const {
+	auto result = BoundTemporaryKeysList();
+	if (isKeysDestroyer()) {
+		return result;
+	}
+	for (const auto &[dcId, key] : _keysForWrite) {
+		const auto i = _dcenters.find(dcId);
+		if (i != end(_dcenters)) {
+			auto keys = i->second->getBoundTemporaryKeys();
+			result.insert(
+				end(result),
+				std::make_move_iterator(begin(keys)),
+				std::make_move_iterator(end(keys)));
+		}
+	}
+	return result;
+}
+
 void Instance::Private::addKeysForDestroy(AuthKeysList &&keys) {
 	Expects(isKeysDestroyer());
 
@@ -1003,11 +1172,39 @@ void Instance::Private::sendRequest(
 		mtpRequestId afterRequestId) {
 	const auto session = getSession(shiftedDcId);
 
+	const auto type = mtpTypeId(
+		request->at(SerializedRequest::kMessageBodyPosition));
+	request->priority = PriorityByType(type);
+	if (needsLayer) {
+		if (auto packed = GzipPacked(request)) {
+			const auto original = tl::count_length(request);
+			const auto size = tl::count_length(packed);
+			auto &stats = _gzipStats[type];
+			++stats.count;
+			stats.original += original;
+			stats.packed += size;
+			DEBUG_LOG(("MTP Info: gzip_packed request of type %1, "
+				"%2 -> %3 bytes, saved for this type: %4 in %5 requests."
+				).arg(type, 0, 16
+				).arg(original
+				).arg(size
+				).arg(stats.original - stats.packed
+				).arg(stats.count));
+			packed->lastSentTime = request->lastSentTime;
+			packed->priority = request->priority;
+			request = std::move(packed);
+		}
+	}
 	request->requestId = requestId;
 	storeRequest(requestId, request, std::move(callbacks));
 
 	const auto toMainDc = (shiftedDcId == 0);
 	const auto realShiftedDcId = session->getDcWithShift();
+	_rpcStats.sent(
+		requestId,
+		type,
+		realShiftedDcId,
+		tl::count_length(request));
 	const auto signedDcId = toMainDc ? -realShiftedDcId : realShiftedDcId;
 	registerRequest(requestId, signedDcId);
 
@@ -1031,6 +1228,7 @@ void Instance::Private::unregisterRequest(mtpRequestId requestId) {
 	DEBUG_LOG(("MTP Info: unregistering request %1.").arg(requestId));
 
 	_requestsDelays.erase(requestId);
+	_rpcStats.forget(requestId);
 
 	{
 		QWriteLocker locker(&_requestMapLock);
@@ -1116,6 +1314,13 @@ bool Instance::Private::hasCallback(mtpRequestId requestId) const {
 
 void Instance::Private::processCallback(const Response &response) {
 	const auto requestId = response.requestId;
+	if (const auto request = getRequest(requestId)) {
+		_rpcStats.received(
+			requestId,
+			response.reply.size() * sizeof(mtpPrime),
+			request->firstSentTime,
+			response.receivedAt);
+	}
 	ResponseHandler handler;
 	{
 		QMutexLocker locker(&_parserMapLock);
@@ -1776,6 +1981,10 @@ void Instance::Private::clearGlobalHandlers() {
 	setSessionResetHandler(nullptr);
 }
 
+QString Instance::Private::rpcStats() const {
+	return _rpcStats.dump(0);
+}
+
 void Instance::Private::prepareToDestroy() {
 	// It accesses Instance in destructor, so it should be destroyed first.
 	_configLoader.reset();
@@ -1903,6 +2112,10 @@ QString Instance::dctransport(ShiftedDcId shiftedDcId) {
 	return _private->dctransport(shiftedDcId);
 }
 
+QString Instance::rpcStats() const {
+	return _private->rpcStats();
+}
+
 void Instance::ping() {
 	_private->ping();
 }
@@ -1949,6 +2162,10 @@ AuthKeysList Instance::getKeysForWrite() const {
 	return _private->getKeysForWrite();
 }
 
+BoundTemporaryKeysList Instance::getTemporaryKeysForWrite() const {
+	return _private->getTemporaryKeysForWrite();
+}
+
 void Instance::addKeysForDestroy(AuthKeysList &&keys) {
 	_private->addKeysForDestroy(std::move(keys));
 }
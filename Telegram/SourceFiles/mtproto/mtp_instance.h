@@ -26,6 +26,8 @@ struct ConfigFields;
 class AuthKey;
 using AuthKeyPtr = std::shared_ptr<AuthKey>;
 using AuthKeysList = std::vector<AuthKeyPtr>;
+struct BoundTemporaryKey;
+using BoundTemporaryKeysList = std::vector<BoundTemporaryKey>;
 enum class Environment : uchar;
 
 class Instance : public QObject {
@@ -46,6 +48,7 @@ public:
 		std::unique_ptr<Config> config;
 		DcId mainDcId = kNotSetMainDc;
 		AuthKeysList keys;
+		BoundTemporaryKeysList temporaryKeys;
 		QString deviceModel;
 		QString systemVersion;
 	};
@@ -87,12 +90,14 @@ public:
 	void dcTemporaryKeyChanged(DcId dcId);
 	[[nodiscard]] rpl::producer<DcId> dcTemporaryKeyChanged() const;
 	[[nodiscard]] AuthKeysList getKeysForWrite() const;
+	[[nodiscard]] BoundTemporaryKeysList getTemporaryKeysForWrite() const;
 	void addKeysForDestroy(AuthKeysList &&keys);
 
 	void restart();
 	void restart(ShiftedDcId shiftedDcId);
 	int32 dcstate(ShiftedDcId shiftedDcId = 0);
 	QString dctransport(ShiftedDcId shiftedDcId = 0);
+	[[nodiscard]] QString rpcStats() const;
 	void ping();
 	void cancel(mtpRequestId requestId);
 	int32 state(mtpRequestId requestId); // < 0 means waiting for such count of ms
@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtCore/QDataStream>
 
+#include <openssl/evp.h>
+
 namespace MTP {
 
 AuthKey::AuthKey(Type type, DcId dcId, const Data &data)
@@ -27,6 +29,16 @@ AuthKey::AuthKey(const Data &data) : _type(Type::Local), _key(data) {
 	countKeyId();
 }
 
+std::shared_ptr<AuthKey> AuthKey::RestoreTemporary(
+		DcId dcId,
+		const Data &data,
+		TimeId expiresAt) {
+	auto result = std::make_shared<AuthKey>(Type::Temporary, dcId, data);
+	result->_creationTime = 0;
+	result->_expiresAt = expiresAt;
+	return result;
+}
+
 AuthKey::Type AuthKey::type() const {
 	return _type;
 }
@@ -168,7 +180,66 @@ void aesIgeDecryptRaw(const void *src, void *dst, uint32 len, const void *key, c
 	AES_ige_encrypt(static_cast<const uchar*>(src), static_cast<uchar*>(dst), len, &aes, aes_iv, AES_DECRYPT);
 }
 
+void CTRState::ContextDeleter::operator()(
+		evp_cipher_ctx_st *context) const {
+	EVP_CIPHER_CTX_free(context);
+}
+
+namespace {
+
+[[nodiscard]] auto CreateCtrContext(
+		const void *key,
+		const CTRState &state)
+-> std::unique_ptr<EVP_CIPHER_CTX, CTRState::ContextDeleter> {
+	if (state.num != 0) {
+		return nullptr;
+	}
+	auto result = std::unique_ptr<EVP_CIPHER_CTX, CTRState::ContextDeleter>(
+		EVP_CIPHER_CTX_new());
+	if (!result) {
+		return nullptr;
+	}
+
+	// EVP picks AES-NI / ARMv8 Crypto Extensions at runtime and processes
+	// several counter blocks at once, unlike the plain AES_encrypt.
+	const auto done = EVP_EncryptInit_ex(
+		result.get(),
+		EVP_aes_256_ctr(),
+		nullptr,
+		static_cast<const uchar*>(key),
+		state.ivec);
+	return done ? result : nullptr;
+}
+
+} // namespace
+
 void aesCtrEncrypt(bytes::span data, const void *key, CTRState *state) {
+	if (!state->context) {
+		state->context = CreateCtrContext(key, *state);
+	}
+	if (const auto context = state->context.get()) {
+		auto left = std::size_t(data.size());
+		auto from = reinterpret_cast<uchar*>(data.data());
+		while (left > 0) {
+			const auto chunk = int(std::min(
+				left,
+				std::size_t(std::numeric_limits<int>::max() / 2)));
+			auto written = 0;
+			const auto done = EVP_EncryptUpdate(
+				context,
+				from,
+				&written,
+				from,
+				chunk);
+
+			// The stream position is lost on a failure, nothing to recover.
+			Assert(done == 1 && written == chunk);
+			from += chunk;
+			left -= chunk;
+		}
+		return;
+	}
+
 	AES_KEY aes;
 	AES_set_encrypt_key(static_cast<const uchar*>(key), 256, &aes);
 
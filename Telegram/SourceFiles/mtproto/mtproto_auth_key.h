@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <array>
 #include <memory>
 
+struct evp_cipher_ctx_st;
+
 namespace MTP {
 
 class AuthKey {
@@ -28,6 +30,12 @@ public:
 	AuthKey(Type type, DcId dcId, const Data &data);
 	explicit AuthKey(const Data &data);
 
+	// Temporary key read from the disk, its creation time is unknown.
+	[[nodiscard]] static std::shared_ptr<AuthKey> RestoreTemporary(
+		DcId dcId,
+		const Data &data,
+		TimeId expiresAt);
+
 	AuthKey(const AuthKey &other) = delete;
 	AuthKey &operator=(const AuthKey &other) = delete;
 
@@ -65,6 +73,13 @@ private:
 using AuthKeyPtr = std::shared_ptr<AuthKey>;
 using AuthKeysList = std::vector<AuthKeyPtr>;
 
+struct BoundTemporaryKey {
+	AuthKeyPtr key;
+	AuthKey::KeyId persistentKeyId = 0;
+	bool mediaCluster = false;
+};
+using BoundTemporaryKeysList = std::vector<BoundTemporaryKey>;
+
 void aesIgeEncryptRaw(const void *src, void *dst, uint32 len, const void *key, const void *iv);
 void aesIgeDecryptRaw(const void *src, void *dst, uint32 len, const void *key, const void *iv);
 
@@ -116,9 +131,23 @@ struct CTRState {
 	static constexpr int IvecSize = 16;
 	static constexpr int EcountSize = 16;
 
+	CTRState() = default;
+	CTRState(const CTRState &other) = delete;
+	CTRState &operator=(const CTRState &other) = delete;
+	CTRState(CTRState &&other) = default;
+	CTRState &operator=(CTRState &&other) = default;
+
 	uchar ivec[IvecSize] = { 0 };
 	uint32 num = 0;
 	uchar ecount[EcountSize] = { 0 };
+
+	struct ContextDeleter {
+		void operator()(evp_cipher_ctx_st *context) const;
+	};
+
+	// Created on the first use from the key and ivec, after that it holds
+	// the counter itself and ivec / num / ecount are not updated anymore.
+	std::unique_ptr<evp_cipher_ctx_st, ContextDeleter> context;
 };
 void aesCtrEncrypt(bytes::span data, const void *key, CTRState *state);
 
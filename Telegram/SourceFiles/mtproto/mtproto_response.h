@@ -9,6 +9,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/flat_set.h"
 
+#include <crl/crl_time.h>
+
 namespace MTP {
 
 class Error {
@@ -58,6 +60,7 @@ struct Response {
 	mtpBuffer reply;
 	mtpMsgId outerMsgId = 0;
 	mtpRequestId requestId = 0;
+	crl::time receivedAt = 0;
 };
 
 using DoneHandler = FnMut<bool(const Response&)>;
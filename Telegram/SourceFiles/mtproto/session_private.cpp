@@ -60,6 +60,11 @@ constexpr auto kSendStateRequestWaiting = crl::time(1000);
 // How much time to wait for some more requests, when sending msg acks.
 constexpr auto kAckSendWaiting = 10 * crl::time(1000);
 
+// Background requests above this size are left for the next container.
+constexpr auto kBackgroundContainerInts = 16 * 1024;
+
+constexpr auto kQueueWaitLogPeriod = 300 * crl::time(1000);
+
 auto SyncTimeRequestDuration = kFastRequestDuration;
 
 using namespace details;
@@ -164,6 +169,7 @@ SessionPrivate::SessionPrivate(
 
 	moveToThread(thread);
 
+	_firstResponseStarted = crl::now();
 	InvokeQueued(this, [=] {
 		_clearOldContainersTimer.callEach(kSentContainerLives);
 		connectToServer();
@@ -699,16 +705,18 @@ void SessionPrivate::tryToSend() {
 	bool needAnyResponse = false;
 	SerializedRequest toSendRequest;
 	{
-		QWriteLocker locker1(_sessionData->toSendMutex());
-
 		auto scheduleCheckSentRequests = false;
 
-		auto toSendDummy = base::flat_map<mtpRequestId, SerializedRequest>();
-		auto &toSend = sendAll
-			? _sessionData->toSendMap()
-			: toSendDummy;
-		if (!sendAll) {
-			locker1.unlock();
+		// Swap the whole queue out, so that adding new requests from the
+		// main thread doesn't wait while we serialize the container.
+		auto &toSend = _toSendTaken;
+		toSend.clear();
+		if (sendAll) {
+			{
+				QWriteLocker locker(_sessionData->toSendMutex());
+				std::swap(toSend, _sessionData->toSendMap());
+			}
+			deferBackgroundRequests(toSend);
 		}
 
 		uint32 toSendCount = toSend.size();
@@ -738,10 +746,7 @@ void SessionPrivate::tryToSend() {
 			: toSend.begin()->second;
 		if (toSendCount == 1 && !first->forceSendInContainer) {
 			toSendRequest = first;
-			if (sendAll) {
-				toSend.clear();
-				locker1.unlock();
-			}
+			toSend.clear();
 
 			const auto msgId = prepareToSend(
 				toSendRequest,
@@ -953,6 +958,98 @@ void SessionPrivate::tryToSend() {
 	sendSecureRequest(std::move(toSendRequest), needAnyResponse);
 }
 
+void SessionPrivate::deferBackgroundRequests(
+		base::flat_map<mtpRequestId, SerializedRequest> &toSend) {
+	const auto now = crl::now();
+	const auto wasDeferred = [&](
+			const std::vector<SerializedRequest> &deferred,
+			const SerializedRequest &after) {
+		return ranges::any_of(deferred, [&](const SerializedRequest &request) {
+			return (&*request == &*after);
+		});
+	};
+	auto deferred = std::vector<SerializedRequest>();
+	auto backgroundInts = uint32(0);
+	auto backgroundFull = false;
+	for (auto i = toSend.begin(); i != toSend.end();) {
+		const auto &request = i->second;
+		auto defer = request->after
+			&& !deferred.empty()
+			&& wasDeferred(deferred, request->after);
+		if (!defer && request->priority == RequestPriority::Background) {
+			const auto size = request.messageSize();
+			if (backgroundFull
+				|| (backgroundInts > 0
+					&& backgroundInts + size > kBackgroundContainerInts)) {
+				backgroundFull = defer = true;
+			} else {
+				backgroundInts += size;
+			}
+		}
+		if (defer) {
+			deferred.push_back(std::move(i->second));
+			i = toSend.erase(i);
+			continue;
+		}
+		if (!request->firstSentTime) {
+			request->firstSentTime = now;
+		}
+		auto &wait = _queueWait[int(request->priority)];
+		const auto waited = std::max(now - request->lastSentTime, crl::time(0));
+		++wait.count;
+		wait.sum += waited;
+		accumulate_max(wait.max, waited);
+		++i;
+	}
+	if (!_queueWaitLogged) {
+		_queueWaitLogged = now;
+	} else if (now - _queueWaitLogged >= kQueueWaitLogPeriod) {
+		logQueueWait();
+		_queueWaitLogged = now;
+	}
+	if (deferred.empty()) {
+		return;
+	}
+	DEBUG_LOG(("MTP Info: dc %1 deferring %2 background requests."
+		).arg(_shiftedDcId
+		).arg(deferred.size()));
+	{
+		QWriteLocker locker(_sessionData->toSendMutex());
+		auto &queue = _sessionData->toSendMap();
+		for (auto &request : deferred) {
+			const auto requestId = request->requestId;
+			queue.emplace(requestId, std::move(request));
+		}
+	}
+	_sessionData->queueSendAnything();
+}
+
+void SessionPrivate::logQueueWait() {
+	const auto names = std::array<const char*, kRequestPrioritiesCount>{
+		"interactive",
+		"regular",
+		"background",
+	};
+	auto parts = QStringList();
+	for (auto i = 0; i != kRequestPrioritiesCount; ++i) {
+		auto &wait = _queueWait[i];
+		if (!wait.count) {
+			continue;
+		}
+		parts.push_back(QString("%1: %2 requests, avg %3 ms, max %4 ms"
+		).arg(names[i]
+		).arg(wait.count
+		).arg(wait.sum / wait.count
+		).arg(wait.max));
+		wait = QueueWait();
+	}
+	if (!parts.isEmpty()) {
+		LOG(("MTP Info: dc %1 queue wait, %2."
+			).arg(_shiftedDcId
+			).arg(parts.join(", ")));
+	}
+}
+
 void SessionPrivate::retryByTimer() {
 	if (_retryTimeout < 3) {
 		++_retryTimeout;
@@ -1368,6 +1465,18 @@ void SessionPrivate::handleReceived() {
 				.serverTime = serverTime,
 				.badTime = badTime,
 			});
+			if (res == HandleResult::Success && !_firstResponseReceived) {
+				// Keys read from the disk have no known creation time.
+				const auto created = _encryptionKey->creationTime();
+				_firstResponseReceived = true;
+				LOG(("MTP Info: first response in dc %1 after %2 ms, "
+					"temporary key %3."
+					).arg(_shiftedDcId
+					).arg(crl::now() - _firstResponseStarted
+					).arg((created >= _firstResponseStarted)
+						? "created"
+						: "reused"));
+			}
 		} else if (registered == ReceivedIdsManager::Result::TooOld) {
 			res = HandleResult::ResetSession;
 		}
@@ -1602,6 +1711,7 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 					.reply = std::move(reply),
 					.outerMsgId = info.outerMsgId,
 					.requestId = requestId,
+					.receivedAt = crl::now(),
 				});
 			} else {
 				DEBUG_LOG(("Message Error: "
@@ -1830,6 +1940,7 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 				.reply = std::move(response),
 				.outerMsgId = info.outerMsgId,
 				.requestId = requestId,
+				.receivedAt = crl::now(),
 			});
 		} else {
 			DEBUG_LOG(("RPC Info: requestId not found for msgId %1").arg(requestMsgId));
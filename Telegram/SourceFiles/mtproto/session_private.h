@@ -100,6 +100,9 @@ private:
 
 	void checkSentRequests();
 	void clearOldContainers();
+	void deferBackgroundRequests(
+		base::flat_map<mtpRequestId, SerializedRequest> &toSend);
+	void logQueueWait();
 
 	mtpMsgId placeToContainer(
 		SerializedRequest &toSendRequest,
@@ -217,6 +220,15 @@ private:
 	base::Timer _clearOldContainersTimer;
 
 	std::shared_ptr<SessionData> _sessionData;
+	base::flat_map<mtpRequestId, SerializedRequest> _toSendTaken;
+
+	struct QueueWait {
+		int64 count = 0;
+		crl::time sum = 0;
+		crl::time max = 0;
+	};
+	std::array<QueueWait, kRequestPrioritiesCount> _queueWait;
+	crl::time _queueWaitLogged = 0;
 	std::unique_ptr<SessionOptions> _options;
 	AuthKeyPtr _encryptionKey;
 	uint64 _keyId = 0;
@@ -238,6 +250,10 @@ private:
 	mtpMsgId _bindMsgId = 0;
 	crl::time _bindMessageSent = 0;
 
+	// Time from the session start till the first handled response.
+	crl::time _firstResponseStarted = 0;
+	bool _firstResponseReceived = false;
+
 };
 
 } // namespace details
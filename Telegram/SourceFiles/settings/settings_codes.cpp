@@ -103,6 +103,13 @@ auto GenerateCodes() {
 			Ui::hideLayer();
 		} }));
 	});
+	codes.emplace(u"rpcstats"_q, [](SessionController *window) {
+		if (window) {
+			const auto stats = window->session().account().mtp().rpcStats();
+			LOG(("MTP Info: rpc stats by traffic:\n%1").arg(stats));
+			Ui::Toast::Show("RPC stats were written to 'log.txt'.");
+		}
+	});
 	codes.emplace(u"getdifference"_q, [](SessionController *window) {
 		if (window) {
 			window->session().updates().getDifference();
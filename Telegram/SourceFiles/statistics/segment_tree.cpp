@@ -7,10 +7,94 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "statistics/segment_tree.h"
 
+#include <bit>
+
 namespace Statistic {
 namespace {
 
 constexpr auto kMinArraySize = size_t(30);
+constexpr auto kBlockSize = 16;
+
+template <typename Better>
+[[nodiscard]] int Scan(
+		const std::vector<int> &array,
+		int from,
+		int to,
+		Better better) {
+	auto result = from;
+	for (auto i = from + 1; i <= to; ++i) {
+		if (better(array[i], array[result])) {
+			result = i;
+		}
+	}
+	return result;
+}
+
+template <typename Better>
+[[nodiscard]] std::vector<std::vector<int>> BuildLevels(
+		const std::vector<int> &array,
+		Better better) {
+	const auto size = int(array.size());
+	const auto blocks = (size + kBlockSize - 1) / kBlockSize;
+
+	auto result = std::vector<std::vector<int>>();
+	auto &first = result.emplace_back();
+	first.reserve(blocks);
+	for (auto i = 0; i != blocks; ++i) {
+		const auto from = i * kBlockSize;
+		const auto till = std::min(from + kBlockSize, size);
+		first.push_back(Scan(array, from, till - 1, better));
+	}
+	for (auto width = 2; width <= blocks; width *= 2) {
+		const auto half = width / 2;
+		auto next = std::vector<int>();
+		next.reserve(blocks - width + 1);
+		for (auto i = 0; i + width <= blocks; ++i) {
+			const auto a = result.back()[i];
+			const auto b = result.back()[i + half];
+			next.push_back(better(array[b], array[a]) ? b : a);
+		}
+		result.push_back(std::move(next));
+	}
+	return result;
+}
+
+template <typename Better>
+[[nodiscard]] int Query(
+		const std::vector<int> &array,
+		const std::vector<std::vector<int>> &levels,
+		int from,
+		int to,
+		Better better) {
+	from = std::max(from, 0);
+	to = std::min(to, int(array.size()) - 1);
+	if (from > to) {
+		return -1;
+	}
+	const auto fromBlock = from / kBlockSize;
+	const auto toBlock = to / kBlockSize;
+	if (levels.empty() || (toBlock - fromBlock < 2)) {
+		return Scan(array, from, to, better);
+	}
+	const auto pick = [&](int a, int b) {
+		return better(array[b], array[a]) ? b : a;
+	};
+
+	// Partial block at the start, two overlapping power-of-two
+	// ranges of full blocks in the middle, partial block at the end.
+	auto result = Scan(
+		array,
+		from,
+		(fromBlock + 1) * kBlockSize - 1,
+		better);
+	const auto first = fromBlock + 1;
+	const auto count = toBlock - first;
+	const auto level = int(std::bit_width(unsigned(count))) - 1;
+	const auto &blocks = levels[level];
+	result = pick(result, blocks[first]);
+	result = pick(result, blocks[toBlock - (1 << level)]);
+	return pick(result, Scan(array, toBlock * kBlockSize, to, better));
+}
 
 } // namespace
 
@@ -19,36 +103,19 @@ SegmentTree::SegmentTree(std::vector<int> array)
 	if (_array.size() < kMinArraySize) {
 		return;
 	}
+	_maxLevels = BuildLevels(_array, std::greater<>());
+	_minLevels = BuildLevels(_array, std::less<>());
+}
 
-	// The max size of this array is about 2 * 2 ^ log2(n) + 1.
-	const auto size = 2 * std::pow(
-		2.,
-		std::floor((std::log(_array.size()) / std::log(2.)) + 1));
-	_heap.resize(int(size));
-	build(1, 0, _array.size());
+int SegmentTree::rMaxIndexQ(int from, int to) const {
+	return Query(_array, _maxLevels, from, to, std::greater<>());
 }
 
-void SegmentTree::build(int v, int from, int size) {
-	_heap[v].from = from;
-	_heap[v].to = (from + size - 1);
-
-	if (size == 1) {
-		_heap[v].sum = _array[from];
-		_heap[v].max = _array[from];
-		_heap[v].min = _array[from];
-	} else {
-		// Build children.
-		build(2 * v, from, size / 2);
-		build(2 * v + 1, from + size / 2, size - size / 2);
-
-		_heap[v].sum = _heap[2 * v].sum + _heap[2 * v + 1].sum;
-		// max = max of the children.
-		_heap[v].max = std::max(_heap[2 * v].max, _heap[2 * v + 1].max);
-		_heap[v].min = std::min(_heap[2 * v].min, _heap[2 * v + 1].min);
-	}
+int SegmentTree::rMinIndexQ(int from, int to) const {
+	return Query(_array, _minLevels, from, to, std::less<>());
 }
 
-int SegmentTree::rMaxQ(int from, int to) {
+int SegmentTree::rMaxQ(int from, int to) const {
 	if (_array.size() < kMinArraySize) {
 		auto max = 0;
 		from = std::max(from, 0);
@@ -58,33 +125,11 @@ int SegmentTree::rMaxQ(int from, int to) {
 		}
 		return max;
 	}
-	return rMaxQ(1, from, to);
+	const auto index = rMaxIndexQ(from, to);
+	return (index >= 0) ? _array[index] : 0;
 }
 
-int SegmentTree::rMaxQ(int v, int from, int to) {
-	const auto &n = _heap[v];
-	// If you did a range update that contained this node,
-	// you can infer the Min value without going down the tree.
-	if (n.pendingVal && contains(n.from, n.to, from, to)) {
-		return n.pendingVal.value;
-	}
-
-	if (contains(from, to, n.from, n.to)) {
-		return _heap[v].max;
-	}
-
-	if (intersects(from, to, n.from, n.to)) {
-		propagate(v);
-		const auto leftMin = rMaxQ(2 * v, from, to);
-		const auto rightMin = rMaxQ(2 * v + 1, from, to);
-
-		return std::max(leftMin, rightMin);
-	}
-
-	return 0;
-}
-
-int SegmentTree::rMinQ(int from, int to) {
+int SegmentTree::rMinQ(int from, int to) const {
 	if (_array.size() < kMinArraySize) {
 		auto min = std::numeric_limits<int>::max();
 		from = std::max(from, 0);
@@ -94,58 +139,10 @@ int SegmentTree::rMinQ(int from, int to) {
 		}
 		return min;
 	}
-	return rMinQ(1, from, to);
-}
-
-int SegmentTree::rMinQ(int v, int from, int to) {
-	const auto &n = _heap[v];
-	// If you did a range update that contained this node,
-	// you can infer the Min value without going down the tree.
-	if (n.pendingVal && contains(n.from, n.to, from, to)) {
-		return n.pendingVal.value;
-	}
-
-	if (contains(from, to, n.from, n.to)) {
-		return _heap[v].min;
-	}
-
-	if (intersects(from, to, n.from, n.to)) {
-		propagate(v);
-		const auto leftMin = rMinQ(2 * v, from, to);
-		const auto rightMin = rMinQ(2 * v + 1, from, to);
-
-		return std::min(leftMin, rightMin);
-	}
-
-	return std::numeric_limits<int>::max();
-}
-
-void SegmentTree::propagate(int v) {
-	auto &n = _heap[v];
-
-	if (n.pendingVal) {
-		const auto value = n.pendingVal.value;
-		n.pendingVal = {};
-		change(_heap[2 * v], value);
-		change(_heap[2 * v + 1], value);
-	}
-}
-
-void SegmentTree::change(SegmentTree::Node &n, int value) {
-	n.pendingVal = { value, true };
-	n.sum = n.size() * value;
-	n.max = value;
-	n.min = value;
-	_array[n.from] = value;
-}
-
-bool SegmentTree::contains(int from1, int to1, int from2, int to2) const {
-	return (from2 >= from1) && (to2 <= to1);
-}
-
-bool SegmentTree::intersects(int from1, int to1, int from2, int to2) const {
-	return ((from1 <= from2) && (to1 >= from2)) // (.[..)..] or (.[...]..)
-		|| ((from1 >= from2) && (from1 <= to2)); // [.(..]..) or [..(..)..
+	const auto index = rMinIndexQ(from, to);
+	return (index >= 0)
+		? _array[index]
+		: std::numeric_limits<int>::max();
 }
 
 } // namespace Statistic
@@ -9,6 +9,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Statistic {
 
+// Range extrema over a static array in O(1).
+// Per-block extrema are combined in a sparse table of power-of-two
+// block ranges, the partial blocks at both ends are scanned directly.
 class SegmentTree final {
 public:
 	SegmentTree() = default;
@@ -21,48 +24,19 @@ public:
 		return !empty();
 	}
 
-	[[nodiscard]] int rMaxQ(int from, int to);
-	[[nodiscard]] int rMinQ(int from, int to);
+	[[nodiscard]] int rMaxQ(int from, int to) const;
+	[[nodiscard]] int rMinQ(int from, int to) const;
 
-private:
-	struct Node final {
-		int sum = 0;
-		int max = 0;
-		int min = 0;
-
-		struct PendingVal {
-			[[nodiscard]] explicit operator bool() const {
-				return available;
-			}
-			int value = 0;
-			bool available = false;
-		};
-		PendingVal pendingVal;
-
-		int from = 0;
-		int to = 0;
-
-		[[nodiscard]] int size() {
-			return to - from + 1;
-		}
-	};
+	// Index of the first maximum / minimum, -1 for an empty range.
+	[[nodiscard]] int rMaxIndexQ(int from, int to) const;
+	[[nodiscard]] int rMinIndexQ(int from, int to) const;
 
-	void build(int v, int from, int size);
-	void propagate(int v);
-	void change(Node &n, int value);
-
-	[[nodiscard]] int rMaxQ(int v, int from, int to);
-	[[nodiscard]] int rMinQ(int v, int from, int to);
-
-	[[nodiscard]] bool contains(int from1, int to1, int from2, int to2) const;
-	[[nodiscard]] bool intersects(
-		int from1,
-		int to1,
-		int from2,
-		int to2) const;
+private:
+	using Levels = std::vector<std::vector<int>>;
 
 	std::vector<int> _array;
-	std::vector<Node> _heap;
+	Levels _maxLevels;
+	Levels _minLevels;
 
 };
 
@@ -35,9 +35,9 @@ void PaintChartLine(
 
 	const auto ratio = ratios.ratio(line.id);
 
-	for (auto i = localStart; i <= localEnd; i++) {
+	const auto append = [&](int i) {
 		if (line.y[i] < 0) {
-			continue;
+			return;
 		}
 		const auto xPoint = c.rect.width()
 			* ((c.chartData.xPercentage[i] - c.xPercentageLimits.min)
@@ -46,6 +46,36 @@ void PaintChartLine(
 			/ float64(c.heightLimits.max - c.heightLimits.min);
 		const auto yPoint = (1. - yPercentage) * c.rect.height();
 		chartPoints << QPointF(xPoint, yPoint);
+	};
+	const auto appendRange = [&](int from, int till) {
+		for (auto i = from; i < till; i++) {
+			append(i);
+		}
+	};
+
+	// With more than a couple of points per pixel only the extrema
+	// of each pixel column are visible, so draw just those.
+	const auto columns = c.rect.width() * style::DevicePixelRatio();
+	const auto count = localEnd - localStart + 1;
+	if (!line.segmentTree || columns <= 0 || count <= 2 * columns) {
+		appendRange(localStart, localEnd + 1);
+	} else {
+		chartPoints.reserve(2 * columns + 2);
+		for (auto column = 0; column != columns; ++column) {
+			const auto from = localStart + (count * column) / columns;
+			const auto till = localStart + (count * (column + 1)) / columns;
+			const auto last = till - 1;
+			if (line.segmentTree.rMinQ(from, last) < 0) {
+				appendRange(from, till);
+				continue;
+			}
+			const auto min = line.segmentTree.rMinIndexQ(from, last);
+			const auto max = line.segmentTree.rMaxIndexQ(from, last);
+			append(std::min(min, max));
+			if (min != max) {
+				append(std::max(min, max));
+			}
+		}
 	}
 	p.setPen(QPen(
 		line.color,
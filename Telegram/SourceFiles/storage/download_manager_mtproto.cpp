@@ -890,6 +890,10 @@ void DownloadMtprotoTask::removeFromQueue() {
 	_owner->remove(this);
 }
 
+void DownloadMtprotoTask::checkSendNext() {
+	_owner->checkSendNextAfterSuccess(dcId());
+}
+
 void DownloadMtprotoTask::partLoaded(
 		int64 offset,
 		const QByteArray &bytes) {
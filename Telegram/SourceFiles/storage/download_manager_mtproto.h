@@ -163,6 +163,7 @@ protected:
 
 	void addToQueue(int priority = 0);
 	void removeFromQueue();
+	void checkSendNext();
 
 	[[nodiscard]] ApiWrap &api() const {
 		return _owner->api();
@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_account.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
+#include "storage/file_download_writer.h"
 #include "platform/platform_file_utilities.h"
 #include "main/main_session.h"
 #include "apiwrap.h"
@@ -251,7 +252,16 @@ void FileLoader::start() {
 bool FileLoader::checkForOpen() {
 	if (_filename.isEmpty()
 		|| (_toCache != LoadToFileOnly)
-		|| _fileIsOpen) {
+		|| _fileIsOpen
+		|| _writer) {
+		return true;
+	} else if (resumable() && _fullSize > 0) {
+		_writer = std::make_unique<Storage::FileDownloadWriter>(
+			_filename,
+			_fullSize,
+			cacheKey(),
+			[=] { cancel(FailureReason::FileWriteFailure); },
+			[=] { writerDrainedHook(); });
 		return true;
 	}
 	_fileIsOpen = _file.open(QIODevice::WriteOnly);
@@ -339,6 +349,14 @@ void FileLoader::cancel(FailureReason fail) {
 
 	_cancelled = true;
 	_finished = true;
+	if (const auto writer = base::take(_writer)) {
+		// Network failures may be retried, keep the loaded parts for that.
+		if (fail == FailureReason::OtherFailure && started) {
+			writer->close();
+		} else {
+			writer->remove();
+		}
+	}
 	if (_fileIsOpen) {
 		_file.close();
 		_fileIsOpen = false;
@@ -359,14 +377,36 @@ void FileLoader::cancel(FailureReason fail) {
 }
 
 int64 FileLoader::currentOffset() const {
+	if (_writer) {
+		return _writer->loadedBytes();
+	}
 	return (_fileIsOpen ? _file.size() : _data.size()) - _skippedBytes;
 }
 
+int64 FileLoader::skipLoadedParts(int64 offset) const {
+	return _writer ? _writer->skipLoadedParts(offset) : offset;
+}
+
+bool FileLoader::writerOverloaded() const {
+	return _writer && _writer->overloaded();
+}
+
+void FileLoader::keepLoadedParts() {
+	if (const auto writer = base::take(_writer)) {
+		writer->close();
+	}
+}
+
 bool FileLoader::writeResultPart(int64 offset, bytes::const_span buffer) {
 	Expects(!_finished);
 
 	if (buffer.empty()) {
 		return true;
+	} else if (_writer) {
+		_writer->write(offset, QByteArray(
+			reinterpret_cast<const char*>(buffer.data()),
+			buffer.size()));
+		return true;
 	}
 	if (_fileIsOpen) {
 		auto fsize = _file.size();
@@ -428,6 +468,16 @@ QByteArray FileLoader::readLoadedPartBack(int64 offset, int size) {
 bool FileLoader::finalizeResult() {
 	Expects(!_finished);
 
+	if (_writer) {
+		// The result is ready when the last parts are written in background.
+		if (!_writerFinishing) {
+			_writerFinishing = true;
+			_writer->finish([=](bool success) {
+				writerFinished(success);
+			});
+		}
+		return true;
+	}
 	if (!_filename.isEmpty() && (_toCache == LoadToCacheAsWell)) {
 		if (!_fileIsOpen) {
 			_fileIsOpen = _file.open(QIODevice::WriteOnly);
@@ -446,6 +496,27 @@ bool FileLoader::finalizeResult() {
 		Platform::File::PostprocessDownloaded(
 			QFileInfo(_file).absoluteFilePath());
 	}
+	notifyFinalized();
+	return true;
+}
+
+void FileLoader::writerFinished(bool success) {
+	Expects(_writer != nullptr);
+	Expects(!_finished);
+
+	_writerFinishing = false;
+	if (!success) {
+		cancel(FailureReason::FileWriteFailure);
+		return;
+	}
+	_writer = nullptr;
+	_finished = true;
+	Platform::File::PostprocessDownloaded(
+		QFileInfo(_file).absoluteFilePath());
+	notifyFinalized();
+}
+
+void FileLoader::notifyFinalized() {
 	if (_localStatus == LocalStatus::NotFound) {
 		if (const auto key = fileLocationKey()) {
 			if (!_filename.isEmpty()) {
@@ -470,7 +541,6 @@ bool FileLoader::finalizeResult() {
 	const auto session = _session;
 	_updates.fire_done();
 	session->notifyDownloaderTaskFinished();
-	return true;
 }
 
 std::unique_ptr<FileLoader> CreateFileLoader(
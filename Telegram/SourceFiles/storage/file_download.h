@@ -25,6 +25,8 @@ namespace Cache {
 struct Key;
 } // namespace Cache
 
+class FileDownloadWriter;
+
 // 10 MB max file could be hold in memory
 // This value is used in local cache database settings!
 constexpr auto kMaxFileInMemory = 10 * 1024 * 1024;
@@ -152,6 +154,11 @@ protected:
 	virtual void startLoadingWithPartial(const QByteArray &data) {
 		startLoading();
 	}
+	[[nodiscard]] virtual bool resumable() const {
+		return false;
+	}
+	virtual void writerDrainedHook() {
+	}
 
 	void cancel(FailureReason failed);
 
@@ -159,7 +166,12 @@ protected:
 
 	bool writeResultPart(int64 offset, bytes::const_span buffer);
 	bool finalizeResult();
+	void writerFinished(bool success);
+	void notifyFinalized();
 	[[nodiscard]] QByteArray readLoadedPartBack(int64 offset, int size);
+	[[nodiscard]] int64 skipLoadedParts(int64 offset) const;
+	[[nodiscard]] bool writerOverloaded() const;
+	void keepLoadedParts();
 
 	const not_null<Main::Session*> _session;
 
@@ -172,6 +184,8 @@ protected:
 	QString _filename;
 	QFile _file;
 	bool _fileIsOpen = false;
+	std::unique_ptr<Storage::FileDownloadWriter> _writer;
+	bool _writerFinishing = false;
 
 	LoadToCacheSetting _toCache;
 	LoadFromCloudSetting _fromCloud;
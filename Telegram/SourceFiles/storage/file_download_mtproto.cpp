@@ -115,6 +115,7 @@ mtpFileLoader::mtpFileLoader(
 
 mtpFileLoader::~mtpFileLoader() {
 	if (!_finished) {
+		keepLoadedParts();
 		cancel();
 	}
 }
@@ -131,14 +132,16 @@ bool mtpFileLoader::readyToRequest() const {
 	return !_finished
 		&& !_lastComplete
 		&& (_fullSize != 0 || !haveSentRequests())
-		&& (!_fullSize || _nextRequestOffset < _loadSize);
+		&& (!_fullSize || _nextRequestOffset < _loadSize)
+		&& !writerOverloaded();
 }
 
 int64 mtpFileLoader::takeNextRequestOffset() {
 	Expects(readyToRequest());
 
 	const auto result = _nextRequestOffset;
-	_nextRequestOffset += Storage::kDownloadPartSize;
+	_nextRequestOffset = skipLoadedParts(
+		_nextRequestOffset + Storage::kDownloadPartSize);
 	return result;
 }
 
@@ -181,6 +184,15 @@ bool mtpFileLoader::setWebFileSizeHook(int64 size) {
 }
 
 void mtpFileLoader::startLoading() {
+	_nextRequestOffset = skipLoadedParts(_nextRequestOffset);
+	if (_fullSize
+		&& _nextRequestOffset >= _loadSize
+		&& _nextRequestOffset > 0
+		&& !haveSentRequests()) {
+		// All the parts were written before the download was interrupted.
+		finalizeResult();
+		return;
+	}
 	addToQueue();
 }
 
@@ -197,6 +209,14 @@ void mtpFileLoader::startLoadingWithPartial(const QByteArray &data) {
 	startLoading();
 }
 
+bool mtpFileLoader::resumable() const {
+	return v::is<StorageFileLocation>(location().data);
+}
+
+void mtpFileLoader::writerDrainedHook() {
+	checkSendNext();
+}
+
 void mtpFileLoader::cancelHook() {
 	cancelAllRequests();
 }
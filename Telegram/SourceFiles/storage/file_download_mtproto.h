@@ -60,6 +60,8 @@ private:
 	std::optional<MediaKey> fileLocationKey() const override;
 	void startLoading() override;
 	void startLoadingWithPartial(const QByteArray &data) override;
+	bool resumable() const override;
+	void writerDrainedHook() override;
 	void cancelHook() override;
 
 	bool readyToRequest() const override;
@@ -0,0 +1,446 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/file_download_writer.h"
+
+#include "storage/cache/storage_cache_types.h"
+#include "storage/download_manager_mtproto.h"
+
+#include <QtCore/QSaveFile>
+
+#ifdef Q_OS_WIN
+#include "base/platform/win/base_windows_h.h"
+
+#include <io.h>
+#else // Q_OS_WIN
+#include <unistd.h>
+#endif // Q_OS_WIN
+
+namespace Storage {
+namespace {
+
+constexpr auto kPartsFileVersion = 1;
+constexpr auto kFlushSize = 1024 * 1024;
+constexpr auto kPartsWriteSize = 16 * 1024 * 1024;
+constexpr auto kPartsWriteDelay = crl::time(5000);
+constexpr auto kQueuedBytesLimit = int64(16 * 1024 * 1024);
+
+[[nodiscard]] QString PartialPath(const QString &path) {
+	return path + u".tdownload"_q;
+}
+
+[[nodiscard]] QString PartsPath(const QString &path) {
+	return path + u".tdpart"_q;
+}
+
+[[nodiscard]] int PartsCount(int64 fullSize) {
+	return int((fullSize + kDownloadPartSize - 1) / kDownloadPartSize);
+}
+
+[[nodiscard]] int64 PartSize(int64 fullSize, int index) {
+	const auto offset = index * int64(kDownloadPartSize);
+	return std::min(int64(kDownloadPartSize), fullSize - offset);
+}
+
+// Returns the size of the parts that were not marked before.
+int64 MarkWritten(
+		QBitArray &parts,
+		int64 fullSize,
+		int64 offset,
+		int64 size) {
+	const auto from = int((offset + kDownloadPartSize - 1)
+		/ kDownloadPartSize);
+	const auto till = (offset + size >= fullSize)
+		? parts.size()
+		: int((offset + size) / kDownloadPartSize);
+	auto result = int64();
+	for (auto index = from; index < till; ++index) {
+		if (!parts.testBit(index)) {
+			parts.setBit(index);
+			result += PartSize(fullSize, index);
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] QByteArray PartsHeader(
+		int64 fullSize,
+		const Cache::Key &key) {
+	auto result = QByteArray();
+	QDataStream stream(&result, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream
+		<< quint32(0x54504454) // TDPT
+		<< qint32(kPartsFileVersion)
+		<< qint64(fullSize)
+		<< qint32(kDownloadPartSize)
+		<< quint64(key.high)
+		<< quint64(key.low);
+	return result;
+}
+
+[[nodiscard]] QBitArray ValidParts(
+		const QString &path,
+		int64 fullSize,
+		const QByteArray &header) {
+	const auto partial = QFileInfo(PartialPath(path));
+	const auto parts = QFileInfo(PartsPath(path));
+	if (!partial.isFile()
+		|| !parts.isFile()
+		|| partial.size() > fullSize) {
+		return QBitArray();
+	}
+	const auto count = PartsCount(fullSize);
+	const auto bytes = (count + 7) / 8;
+	QFile file(parts.filePath());
+	const auto valid = file.open(QIODevice::ReadOnly)
+		&& (file.read(header.size()) == header);
+	const auto bits = valid ? file.read(bytes) : QByteArray();
+	if (bits.size() != bytes) {
+		return QBitArray();
+	}
+	auto result = QBitArray::fromBits(bits.constData(), count);
+
+	// Each written part should be inside of the file written so far.
+	for (auto index = count; index != 0; --index) {
+		if (result.testBit(index - 1)) {
+			const auto end = (index - 1) * int64(kDownloadPartSize)
+				+ PartSize(fullSize, index - 1);
+			return (end <= partial.size()) ? result : QBitArray();
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] bool SyncToDisk(const QFile &file) {
+#ifdef Q_OS_WIN
+	const auto handle = HANDLE(_get_osfhandle(file.handle()));
+	return (handle != INVALID_HANDLE_VALUE) && FlushFileBuffers(handle);
+#else // Q_OS_WIN
+	return !fsync(file.handle());
+#endif // Q_OS_WIN
+}
+
+} // namespace
+
+class FileDownloadWriter::Inner final {
+public:
+	Inner(
+		crl::weak_on_queue<Inner> weak,
+		const QString &path,
+		int64 fullSize,
+		QByteArray header,
+		QBitArray parts,
+		bool resumed,
+		Fn<void()> failed);
+	~Inner();
+
+	void write(int64 offset, QByteArray bytes);
+	[[nodiscard]] bool finish();
+	void close();
+	void remove();
+
+private:
+	bool flush();
+	bool sync();
+	bool writeParts();
+	void fail();
+
+	const QString _path;
+	QFile _file;
+	const QString _partsPath;
+	const int64 _fullSize = 0;
+	const QByteArray _header;
+	QBitArray _parts; // Synced to the disk, as written in the bitmap.
+	QBitArray _written;
+	base::flat_map<int64, QByteArray> _pending;
+	int64 _pendingSize = 0;
+	int64 _unsyncedSize = 0;
+	crl::time _partsWritten = 0;
+	Fn<void()> _failed;
+	bool _error = false;
+	bool _finished = false;
+
+};
+
+FileDownloadWriter::Inner::Inner(
+	crl::weak_on_queue<Inner> weak,
+	const QString &path,
+	int64 fullSize,
+	QByteArray header,
+	QBitArray parts,
+	bool resumed,
+	Fn<void()> failed)
+: _path(path)
+, _file(PartialPath(path))
+, _partsPath(PartsPath(path))
+, _fullSize(fullSize)
+, _header(std::move(header))
+, _parts(std::move(parts))
+, _written(_parts)
+, _partsWritten(crl::now())
+, _failed(std::move(failed)) {
+	if (!resumed) {
+		QFile::remove(_partsPath);
+	}
+	if (!_file.open(resumed ? QIODevice::ReadWrite : QIODevice::WriteOnly)) {
+		fail();
+	}
+}
+
+FileDownloadWriter::Inner::~Inner() {
+	close();
+}
+
+void FileDownloadWriter::Inner::write(int64 offset, QByteArray bytes) {
+	if (_error) {
+		return;
+	}
+	_pendingSize += bytes.size();
+	_pending.emplace(offset, std::move(bytes));
+	if (_pendingSize >= kFlushSize) {
+		flush();
+	}
+}
+
+bool FileDownloadWriter::Inner::flush() {
+	if (_error) {
+		return false;
+	} else if (_pending.empty()) {
+		return true;
+	}
+	const auto pending = base::take(_pending);
+	_pendingSize = 0;
+
+	// Adjacent parts are glued together to be written at once.
+	for (auto i = begin(pending); i != end(pending);) {
+		const auto offset = i->first;
+		auto chunk = i->second;
+		for (++i; i != end(pending); ++i) {
+			if (i->first != offset + chunk.size()) {
+				break;
+			}
+			chunk.append(i->second);
+		}
+		if (!_file.seek(offset)
+			|| _file.write(chunk) != qint64(chunk.size())) {
+			fail();
+			return false;
+		}
+		MarkWritten(_written, _fullSize, offset, chunk.size());
+		_unsyncedSize += chunk.size();
+	}
+	if (_unsyncedSize >= kPartsWriteSize
+		|| crl::now() - _partsWritten >= kPartsWriteDelay) {
+		return sync();
+	}
+	return true;
+}
+
+bool FileDownloadWriter::Inner::sync() {
+	if (_error) {
+		return false;
+	} else if (!_unsyncedSize) {
+		return true;
+	}
+
+	// The bitmap is updated only after the data itself is on the disk.
+	if (!_file.flush() || !SyncToDisk(_file)) {
+		fail();
+		return false;
+	}
+	_parts = _written;
+	_unsyncedSize = 0;
+	_partsWritten = crl::now();
+	return writeParts();
+}
+
+bool FileDownloadWriter::Inner::writeParts() {
+	QSaveFile file(_partsPath);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	file.write(_header);
+	file.write(QByteArray::fromRawData(
+		_parts.bits(),
+		(_parts.size() + 7) / 8));
+	return file.commit();
+}
+
+bool FileDownloadWriter::Inner::finish() {
+	if (!flush() || !sync()) {
+		remove();
+		return false;
+	}
+	_file.close();
+	if (QFile::exists(_path)) {
+		QFile::remove(_path);
+	}
+	if (!_file.rename(_path)) {
+		LOG(("Download Error: Could not rename '%1' to '%2'."
+			).arg(_file.fileName()
+			).arg(_path));
+		remove();
+		return false;
+	}
+	QFile::remove(_partsPath);
+	_finished = true;
+	return true;
+}
+
+void FileDownloadWriter::Inner::close() {
+	if (_file.isOpen()) {
+		if (flush()) {
+			sync();
+		}
+		_file.close();
+	}
+}
+
+void FileDownloadWriter::Inner::remove() {
+	if (_finished) {
+		return;
+	}
+	_pending.clear();
+	_pendingSize = 0;
+	_unsyncedSize = 0;
+	_error = true;
+	_file.close();
+	_file.remove();
+	QFile::remove(_partsPath);
+}
+
+void FileDownloadWriter::Inner::fail() {
+	if (!_error) {
+		_error = true;
+		LOG(("Download Error: Could not write to '%1'."
+			).arg(_file.fileName()));
+		_failed();
+	}
+}
+
+bool HasUnfinishedDownload(const QString &path) {
+	return QFile::exists(PartialPath(path));
+}
+
+bool CanResumeDownload(
+		const QString &path,
+		int64 fullSize,
+		const Cache::Key &key) {
+	return (fullSize > 0)
+		&& !ValidParts(path, fullSize, PartsHeader(fullSize, key)).isEmpty();
+}
+
+void RemoveUnfinishedDownload(const QString &path) {
+	QFile::remove(PartialPath(path));
+	QFile::remove(PartsPath(path));
+}
+
+FileDownloadWriter::FileDownloadWriter(
+	const QString &path,
+	int64 fullSize,
+	const Cache::Key &key,
+	Fn<void()> failed,
+	Fn<void()> drained)
+: _fullSize(fullSize)
+, _header(PartsHeader(fullSize, key))
+, _loaded(ValidParts(path, _fullSize, _header))
+, _resumed(!_loaded.isEmpty())
+, _failed(std::move(failed))
+, _drained(std::move(drained))
+, _inner(
+	path,
+	_fullSize,
+	_header,
+	_resumed ? _loaded : QBitArray(PartsCount(_fullSize)),
+	_resumed,
+	[=, weak = base::make_weak(this)] {
+		crl::on_main(weak, [=] { _failed(); });
+	}) {
+	Expects(_fullSize > 0);
+
+	if (!_resumed) {
+		_loaded = QBitArray(PartsCount(_fullSize));
+	}
+	for (auto i = 0, count = PartsCount(_fullSize); i != count; ++i) {
+		if (_loaded.testBit(i)) {
+			_loadedBytes += PartSize(_fullSize, i);
+		}
+	}
+	if (_resumed) {
+		DEBUG_LOG(("Download Info: Resuming '%1' from %2 / %3 bytes."
+			).arg(path
+			).arg(_loadedBytes
+			).arg(_fullSize));
+	}
+}
+
+FileDownloadWriter::~FileDownloadWriter() = default;
+
+bool FileDownloadWriter::resumed() const {
+	return _resumed;
+}
+
+int64 FileDownloadWriter::loadedBytes() const {
+	return _loadedBytes;
+}
+
+int64 FileDownloadWriter::skipLoadedParts(int64 offset) const {
+	auto index = offset / kDownloadPartSize;
+	while (index < _loaded.size() && _loaded.testBit(int(index))) {
+		++index;
+	}
+	return std::max(offset, index * int64(kDownloadPartSize));
+}
+
+bool FileDownloadWriter::overloaded() const {
+	return (_queuedBytes >= kQueuedBytesLimit);
+}
+
+void FileDownloadWriter::write(int64 offset, QByteArray bytes) {
+	const auto size = int64(bytes.size());
+	_loadedBytes += MarkWritten(_loaded, _fullSize, offset, size);
+	_queuedBytes += size;
+	_inner.with([=, weak = base::make_weak(this), bytes = std::move(bytes)](
+			Inner &inner) mutable {
+		inner.write(offset, std::move(bytes));
+		crl::on_main(weak, [=] {
+			written(size);
+		});
+	});
+}
+
+void FileDownloadWriter::written(int64 size) {
+	const auto wasOverloaded = overloaded();
+	_queuedBytes -= size;
+	if (wasOverloaded && !overloaded()) {
+		_drained();
+	}
+}
+
+void FileDownloadWriter::finish(Fn<void(bool)> done) {
+	_inner.with([=, weak = base::make_weak(this)](Inner &inner) {
+		const auto success = inner.finish();
+		crl::on_main(weak, [=] {
+			done(success);
+		});
+	});
+}
+
+void FileDownloadWriter::close() {
+	_inner.with([](Inner &inner) {
+		inner.close();
+	});
+}
+
+void FileDownloadWriter::remove() {
+	_inner.with([](Inner &inner) {
+		inner.remove();
+	});
+}
+
+} // namespace Storage
@@ -0,0 +1,80 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+#include <crl/crl_object_on_queue.h>
+#include <QtCore/QBitArray>
+
+namespace Storage {
+namespace Cache {
+struct Key;
+} // namespace Cache
+
+// An unfinished download of "<path>" is written to "<path>.tdownload" and
+// the bitmap of its written parts is kept in "<path>.tdpart".
+[[nodiscard]] bool HasUnfinishedDownload(const QString &path);
+[[nodiscard]] bool CanResumeDownload(
+	const QString &path,
+	int64 fullSize,
+	const Cache::Key &key);
+void RemoveUnfinishedDownload(const QString &path);
+
+// Writes the downloaded parts to the file on a background queue in large
+// chunks and keeps a bitmap of the written parts in a file nearby, so an
+// interrupted download (even by a crash) could be resumed later.
+// The bitmap is updated rarely, so a crash may lose a few last seconds.
+class FileDownloadWriter final : public base::has_weak_ptr {
+public:
+	FileDownloadWriter(
+		const QString &path,
+		int64 fullSize,
+		const Cache::Key &key,
+		Fn<void()> failed,
+		Fn<void()> drained);
+	~FileDownloadWriter();
+
+	[[nodiscard]] bool resumed() const;
+	[[nodiscard]] int64 loadedBytes() const;
+	[[nodiscard]] int64 skipLoadedParts(int64 offset) const;
+
+	// Too many bytes wait to be written, drained() is called when
+	// the writer is ready to accept more of them.
+	[[nodiscard]] bool overloaded() const;
+
+	void write(int64 offset, QByteArray bytes);
+
+	// Writes the rest of the parts, renames the file to the destination
+	// path and removes the bitmap, then calls done() on the main thread.
+	void finish(Fn<void(bool)> done);
+
+	// Keeps both the file and the bitmap for the download to be resumed.
+	void close();
+
+	void remove();
+
+private:
+	class Inner;
+
+	void written(int64 size);
+
+	const int64 _fullSize = 0;
+	const QByteArray _header;
+	QBitArray _loaded;
+	int64 _loadedBytes = 0;
+	int64 _queuedBytes = 0;
+	bool _resumed = false;
+	Fn<void()> _failed;
+	Fn<void()> _drained;
+
+	crl::object_on_queue<Inner> _inner;
+
+};
+
+} // namespace Storage
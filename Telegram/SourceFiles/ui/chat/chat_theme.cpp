@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/style/style_palette_colorizer.h"
 
 #include <crl/crl_async.h>
+#include <QtCore/QMutex>
 #include <QtGui/QGuiApplication>
 
 namespace Ui {
@@ -29,6 +30,124 @@ constexpr auto kMinimumTiledSize = 512;
 constexpr auto kMaxSize = 2960;
 constexpr auto kMaxContrastValue = 21.;
 constexpr auto kMinAcceptableContrast = 1.14;// 4.5;
+constexpr auto kCachedResultsLimit = int64(96 * 1024 * 1024);
+
+using CachedResultKey = std::tuple<
+	QString, // background.key
+	qint64, // background.prepared.cacheKey()
+	qint64, // background.gradientForFill.cacheKey()
+	int, // area.width()
+	int, // area.height()
+	int, // gradientRotationAdd
+	float64, // gradientProgress
+	float64, // background.patternOpacity
+	bool>; // background.tile
+
+// Rendered backgrounds are shared between all chat themes, so that
+// switching back to a themed chat or restoring the window size reuses
+// the result instead of scaling and compositing the whole area again.
+class CachedResults final {
+public:
+	[[nodiscard]] std::optional<CacheBackgroundResult> find(
+		const CachedResultKey &key);
+	void store(
+		const CachedResultKey &key,
+		const CacheBackgroundResult &result);
+
+	[[nodiscard]] QImage scaledPattern(const QImage &prepared, int size);
+
+private:
+	struct Entry {
+		CacheBackgroundResult result;
+		int64 bytes = 0;
+		uint64 lastUsed = 0;
+	};
+
+	QMutex _mutex;
+	base::flat_map<CachedResultKey, Entry> _entries;
+	int64 _bytes = 0;
+	uint64 _usage = 0;
+
+	qint64 _patternKey = 0;
+	int _patternSize = 0;
+	QImage _pattern;
+
+};
+
+std::optional<CacheBackgroundResult> CachedResults::find(
+		const CachedResultKey &key) {
+	QMutexLocker lock(&_mutex);
+	const auto i = _entries.find(key);
+	if (i == end(_entries)) {
+		return std::nullopt;
+	}
+	i->second.lastUsed = ++_usage;
+	return i->second.result;
+}
+
+void CachedResults::store(
+		const CachedResultKey &key,
+		const CacheBackgroundResult &result) {
+	const auto bytes = int64(result.image.sizeInBytes())
+		+ int64(result.gradient.sizeInBytes());
+	if (result.waitingForNegativePattern
+		|| !bytes
+		|| bytes > kCachedResultsLimit / 4) {
+		return;
+	}
+	QMutexLocker lock(&_mutex);
+	auto &entry = _entries[key];
+	_bytes += bytes - entry.bytes;
+	entry = { result, bytes, ++_usage };
+	while (_bytes > kCachedResultsLimit) {
+		const auto i = ranges::min_element(
+			_entries,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.lastUsed; });
+		_bytes -= i->second.bytes;
+		_entries.erase(i);
+	}
+}
+
+QImage CachedResults::scaledPattern(const QImage &prepared, int size) {
+	QMutexLocker lock(&_mutex);
+	if (_patternKey == prepared.cacheKey() && _patternSize == size) {
+		return _pattern;
+	}
+	lock.unlock();
+
+	auto scaled = prepared.scaled(
+		size,
+		size,
+		Qt::KeepAspectRatio,
+		Qt::SmoothTransformation);
+
+	lock.relock();
+	_patternKey = prepared.cacheKey();
+	_patternSize = size;
+	_pattern = scaled;
+	return scaled;
+}
+
+[[nodiscard]] CachedResults &Results() {
+	static auto result = CachedResults();
+	return result;
+}
+
+[[nodiscard]] CachedResultKey ComputeCachedResultKey(
+		const CacheBackgroundRequest &request) {
+	return {
+		request.background.key,
+		request.background.prepared.cacheKey(),
+		request.background.gradientForFill.cacheKey(),
+		request.area.width(),
+		request.area.height(),
+		request.gradientRotationAdd,
+		request.gradientProgress,
+		request.background.patternOpacity,
+		request.background.tile,
+	};
+}
 
 [[nodiscard]] QColor DefaultBackgroundColor() {
 	return QColor(213, 223, 233);
@@ -91,11 +210,9 @@ constexpr auto kMinAcceptableContrast = 1.14;// 4.5;
 				}
 			}
 			const auto tiled = request.background.isPattern
-				? request.background.prepared.scaled(
-					request.area.height() * ratio,
-					request.area.height() * ratio,
-					Qt::KeepAspectRatio,
-					Qt::SmoothTransformation)
+				? Results().scaledPattern(
+					request.background.prepared,
+					request.area.height() * ratio)
 				: request.background.preparedForTiled;
 			const auto w = tiled.width() / float(ratio);
 			const auto h = tiled.height() / float(ratio);
@@ -191,7 +308,13 @@ bool operator!=(
 
 CacheBackgroundResult CacheBackground(
 		const CacheBackgroundRequest &request) {
-	return CacheBackgroundByRequest(request);
+	const auto key = ComputeCachedResultKey(request);
+	if (auto cached = Results().find(key)) {
+		return std::move(*cached);
+	}
+	auto result = CacheBackgroundByRequest(request);
+	Results().store(key, result);
+	return result;
 }
 
 CachedBackground::CachedBackground(CacheBackgroundResult &&result)
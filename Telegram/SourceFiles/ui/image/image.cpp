@@ -12,11 +12,206 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "ui/ui_utility.h"
 
+#include <list>
+#include <unordered_map>
+
 using namespace Images;
 
 namespace Images {
 namespace {
 
+constexpr auto kDefaultPixmapCacheLimit = int64(160 * 1024 * 1024);
+constexpr auto kPixmapKeepUsedFor = crl::time(200);
+constexpr auto kPixmapCacheLogEach = 4096;
+
+// All prepared pixmaps of all images share one byte budget.
+// Eviction is postponed to the main loop, so that references returned
+// by Image::pix() stay valid for the whole paint that requested them.
+// Pixmaps used during the last few frames are never evicted, so a visible
+// set larger than the budget doesn't get prepared again on each frame.
+class PixmapCache final {
+public:
+	[[nodiscard]] const QPixmap *find(
+		not_null<const Image*> image,
+		uint64 key,
+		QSize size);
+	[[nodiscard]] const QPixmap &insert(
+		not_null<const Image*> image,
+		uint64 key,
+		QPixmap &&pixmap);
+	void forget(not_null<const Image*> image);
+
+	void setLimit(int64 bytes);
+	[[nodiscard]] PixmapCacheStats stats() const;
+
+private:
+	struct Entry {
+		const Image *image = nullptr;
+		uint64 key = 0;
+		QPixmap pixmap;
+		int64 bytes = 0;
+		crl::time lastUsed = 0;
+	};
+	using Entries = std::list<Entry>;
+
+	void remove(Entries::iterator i);
+	void scheduleEviction();
+	void evict();
+	void countLookup(bool hit);
+
+	Entries _entries; // Most recently used first.
+	std::unordered_map<
+		const Image*,
+		base::flat_map<uint64, Entries::iterator>> _index;
+	int64 _bytes = 0;
+	int64 _limit = kDefaultPixmapCacheLimit;
+	int64 _hits = 0;
+	int64 _misses = 0;
+	int64 _evicted = 0;
+	bool _evictionScheduled = false;
+
+};
+
+PixmapCache GlobalCache;
+
+[[nodiscard]] int64 ComputeBytes(const QPixmap &pixmap) {
+	return int64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+const QPixmap *PixmapCache::find(
+		not_null<const Image*> image,
+		uint64 key,
+		QSize size) {
+	const auto i = _index.find(image);
+	if (i == end(_index)) {
+		countLookup(false);
+		return nullptr;
+	}
+	const auto j = i->second.find(key);
+	if (j == end(i->second) || j->second->pixmap.size() != size) {
+		countLookup(false);
+		return nullptr;
+	}
+	countLookup(true);
+	const auto entry = j->second;
+	entry->lastUsed = crl::now();
+	_entries.splice(begin(_entries), _entries, entry);
+	return &entry->pixmap;
+}
+
+const QPixmap &PixmapCache::insert(
+		not_null<const Image*> image,
+		uint64 key,
+		QPixmap &&pixmap) {
+	auto &keys = _index[image];
+	if (const auto i = keys.find(key); i != end(keys)) {
+		_bytes -= i->second->bytes;
+		_entries.erase(i->second);
+		keys.erase(i);
+	}
+	const auto bytes = ComputeBytes(pixmap);
+	_entries.push_front({
+		.image = image,
+		.key = key,
+		.pixmap = std::move(pixmap),
+		.bytes = bytes,
+		.lastUsed = crl::now(),
+	});
+	keys.emplace(key, begin(_entries));
+	_bytes += bytes;
+	if (_bytes > _limit) {
+		scheduleEviction();
+	}
+	return _entries.front().pixmap;
+}
+
+void PixmapCache::forget(not_null<const Image*> image) {
+	const auto i = _index.find(image);
+	if (i == end(_index)) {
+		return;
+	}
+	for (const auto &[key, entry] : i->second) {
+		_bytes -= entry->bytes;
+		_entries.erase(entry);
+	}
+	_index.erase(i);
+}
+
+void PixmapCache::setLimit(int64 bytes) {
+	_limit = std::max(bytes, int64(0));
+	if (_bytes > _limit) {
+		scheduleEviction();
+	}
+}
+
+PixmapCacheStats PixmapCache::stats() const {
+	return {
+		.bytes = _bytes,
+		.limit = _limit,
+		.entries = int(_entries.size()),
+		.hits = _hits,
+		.misses = _misses,
+		.evicted = _evicted,
+	};
+}
+
+void PixmapCache::countLookup(bool hit) {
+	++(hit ? _hits : _misses);
+	const auto lookups = _hits + _misses;
+	if (lookups % kPixmapCacheLogEach) {
+		return;
+	}
+	DEBUG_LOG(("Image Cache: %1 pixmaps, %2 / %3 bytes, "
+		"%4 hits / %5 lookups (%6%), %7 evicted."
+		).arg(_entries.size()
+		).arg(_bytes
+		).arg(_limit
+		).arg(_hits
+		).arg(lookups
+		).arg(_hits * 100 / lookups
+		).arg(_evicted));
+}
+
+void PixmapCache::remove(Entries::iterator i) {
+	const auto j = _index.find(i->image);
+	Assert(j != end(_index));
+
+	j->second.remove(i->key);
+	if (j->second.empty()) {
+		_index.erase(j);
+	}
+	_bytes -= i->bytes;
+	_entries.erase(i);
+}
+
+void PixmapCache::scheduleEviction() {
+	if (_evictionScheduled) {
+		return;
+	}
+	_evictionScheduled = true;
+	crl::on_main([=] {
+		_evictionScheduled = false;
+		evict();
+	});
+}
+
+void PixmapCache::evict() {
+	const auto used = crl::now() - kPixmapKeepUsedFor;
+	const auto evictTo = _limit * 3 / 4;
+	auto evicted = 0;
+	while (_bytes > evictTo
+		&& !_entries.empty()
+		&& _entries.back().lastUsed < used) {
+		remove(std::prev(end(_entries)));
+		++evicted;
+	}
+	_evicted += evicted;
+	DEBUG_LOG(("Image Cache: evicted %1, %2 pixmaps, %3 bytes kept."
+		).arg(evicted
+		).arg(_entries.size()
+		).arg(_bytes));
+}
+
 [[nodiscard]] uint64 PixKey(int width, int height, Options options) {
 	return static_cast<uint64>(width)
 		| (static_cast<uint64>(height) << 24)
@@ -41,6 +236,14 @@ namespace {
 
 } // namespace
 
+void SetPixmapCacheLimit(int64 bytes) {
+	GlobalCache.setLimit(bytes);
+}
+
+PixmapCacheStats CollectPixmapCacheStats() {
+	return GlobalCache.stats();
+}
+
 } // namespace Images
 
 Image::Image(const QString &path)
@@ -56,6 +259,10 @@ Image::Image(QImage &&data)
 	Expects(!_data.isNull());
 }
 
+Image::~Image() {
+	Images::GlobalCache.forget(this);
+}
+
 not_null<Image*> Image::Empty() {
 	static auto result = Image([] {
 		const auto factor = style::DevicePixelRatio();
@@ -106,10 +313,10 @@ const QPixmap &Image::cached(
 	const auto outer = args.outer;
 	const auto size = outer.isEmpty() ? QSize(w, h) : outer * ratio;
 	const auto k = single ? SinglePixKey(args) : PixKey(w, h, args);
-	const auto i = _cache.find(k);
-	return (i != _cache.cend() && i->second.size() == size)
-		? i->second
-		: _cache.emplace_or_assign(k, prepare(w, h, args)).first->second;
+	if (const auto result = Images::GlobalCache.find(this, k, size)) {
+		return *result;
+	}
+	return Images::GlobalCache.insert(this, k, prepare(w, h, args));
 }
 
 QPixmap Image::prepare(int w, int h, const Images::PrepareArgs &args) const {
@@ -11,11 +11,28 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 class QPainterPath;
 
+namespace Images {
+
+struct PixmapCacheStats {
+	int64 bytes = 0;
+	int64 limit = 0;
+	int entries = 0;
+	int64 hits = 0;
+	int64 misses = 0;
+	int64 evicted = 0;
+};
+
+void SetPixmapCacheLimit(int64 bytes);
+[[nodiscard]] PixmapCacheStats CollectPixmapCacheStats();
+
+} // namespace Images
+
 class Image final {
 public:
 	explicit Image(const QString &path);
 	explicit Image(const QByteArray &content);
 	explicit Image(QImage &&data);
+	~Image();
 
 	[[nodiscard]] static not_null<Image*> Empty(); // 1x1 transparent
 	[[nodiscard]] static not_null<Image*> BlankMedia(); // 1x1 black
@@ -99,6 +116,5 @@ private:
 		bool single) const;
 
 	const QImage _data;
-	mutable base::flat_map<uint64, QPixmap> _cache;
 
 };
@@ -48,6 +48,17 @@ namespace Notifications {
 namespace Default {
 namespace {
 
+// Messages arriving in the same chat within this timeout update
+// the notification that is already on screen instead of adding one.
+constexpr auto kMergeBurstTimeout = 3 * crl::time(1000);
+
+// Notification widgets are created not faster than one per period,
+// with up to kCreateBurst of them shown at once.
+constexpr auto kCreateBurst = 3;
+constexpr auto kCreateTokenPeriod = crl::time(400);
+
+constexpr auto kCachePoolLimit = 4;
+
 [[nodiscard]] QPoint notificationStartPosition() {
 	const auto corner = Core::App().settings().notificationsCorner();
 	const auto window = Core::App().activePrimaryWindow();
@@ -76,7 +87,9 @@ std::unique_ptr<Manager> Create(System *system) {
 
 Manager::Manager(System *system)
 : Notifications::Manager(system)
-, _inputCheckTimer([=] { checkLastInput(); }) {
+, _inputCheckTimer([=] { checkLastInput(); })
+, _createTokens(kCreateBurst)
+, _createTimer([=] { showNextFromQueue(); }) {
 	system->settingsChanged(
 	) | rpl::start_with_next([=](ChangeType change) {
 		settingsChanged(change);
@@ -234,6 +247,9 @@ void Manager::showNextFromQueue() {
 	auto startShift = 0;
 	auto shiftDirection = notificationShiftDirection();
 	do {
+		if (!takeCreateToken()) {
+			break;
+		}
 		auto queued = _queuedNotifications.front();
 		_queuedNotifications.pop_front();
 
@@ -251,6 +267,7 @@ void Manager::showNextFromQueue() {
 			startPosition,
 			startShift,
 			shiftDirection));
+		++_shownCount;
 		--count;
 	} while (count > 0 && !_queuedNotifications.empty());
 
@@ -359,11 +376,91 @@ void Manager::removeWidget(internal::Widget *remove) {
 	showNextFromQueue();
 }
 
+bool Manager::takeCreateToken() {
+	const auto now = crl::now();
+	const auto refilled = (now - _createTokensUpdated) / kCreateTokenPeriod;
+	if (refilled > 0) {
+		_createTokens = int(std::min(
+			_createTokens + refilled,
+			crl::time(kCreateBurst)));
+		_createTokensUpdated = (_createTokens == kCreateBurst)
+			? now
+			: (_createTokensUpdated + refilled * kCreateTokenPeriod);
+	}
+	if (!_createTokens) {
+		if (!_createTimer.isActive()) {
+			_createTimer.callOnce(
+				_createTokensUpdated + kCreateTokenPeriod - now);
+		}
+		return false;
+	}
+	--_createTokens;
+	return true;
+}
+
+bool Manager::mergeIntoExisting(const QueuedNotification &queued) {
+	if (!queued.item || !queued.reaction.empty() || queued.fromScheduled) {
+		return false;
+	}
+	for (auto &entry : _queuedNotifications) {
+		if (entry.history == queued.history
+			&& entry.topicRootId == queued.topicRootId
+			&& entry.item
+			&& entry.reaction.empty()
+			&& !entry.fromScheduled) {
+			entry.author = queued.author;
+			entry.item = queued.item;
+			++_mergedCount;
+			return true;
+		}
+	}
+	for (const auto &notification : _notifications) {
+		if (notification->canMergeWith(queued.history, queued.topicRootId)) {
+			notification->mergeWith(queued.author, queued.item);
+			++_mergedCount;
+			DEBUG_LOG(("Notifications: merged into shown, "
+				"%1 shown, %2 merged."
+				).arg(_shownCount
+				).arg(_mergedCount));
+			return true;
+		}
+	}
+	return false;
+}
+
 void Manager::doShowNotification(NotificationFields &&fields) {
-	_queuedNotifications.emplace_back(std::move(fields));
+	auto queued = QueuedNotification(std::move(fields));
+	if (mergeIntoExisting(queued)) {
+		return;
+	}
+	_queuedNotifications.push_back(std::move(queued));
 	showNextFromQueue();
 }
 
+QImage Manager::takeCache(QSize size) {
+	const auto ratio = style::DevicePixelRatio();
+	const auto i = ranges::find_if(_cachePool, [&](const QImage &image) {
+		return (image.size() == size * ratio)
+			&& (image.devicePixelRatio() == ratio);
+	});
+	if (i != end(_cachePool)) {
+		auto result = std::move(*i);
+		_cachePool.erase(i);
+		return result;
+	}
+	auto result = QImage(
+		size * ratio,
+		QImage::Format_ARGB32_Premultiplied);
+	result.setDevicePixelRatio(ratio);
+	return result;
+}
+
+void Manager::releaseCache(QImage &&cache) {
+	if (!cache.isNull() && _cachePool.size() < kCachePoolLimit) {
+		_cachePool.push_back(std::move(cache));
+	}
+}
+
 void Manager::doClearAll() {
 	_queuedNotifications.clear();
 	for (const auto &notification : _notifications) {
@@ -700,6 +797,10 @@ Notification::Notification(
 	show();
 }
 
+Notification::~Notification() {
+	manager()->releaseCache(base::take(_cache));
+}
+
 void Notification::updateReplyGeometry() {
 	_reply->moveToRight(_replyPadding, height() - _reply->height() - _replyPadding);
 }
@@ -861,10 +962,7 @@ void Notification::updateNotifyDisplay() {
 	_hideReplyButton = options.hideReplyButton;
 
 	int32 w = width(), h = height();
-	auto img = QImage(
-		size() * style::DevicePixelRatio(),
-		QImage::Format_ARGB32_Premultiplied);
-	img.setDevicePixelRatio(style::DevicePixelRatio());
+	auto img = manager()->takeCache(size());
 	img.fill(st::notificationBg->c);
 
 	{
@@ -1008,7 +1106,7 @@ void Notification::updateNotifyDisplay() {
 		paintTitle(p);
 	}
 
-	_cache = std::move(img);
+	manager()->releaseCache(std::exchange(_cache, std::move(img)));
 	if (!canReply()) {
 		toggleActionButtons(false);
 	}
@@ -1170,6 +1268,32 @@ bool Notification::unlinkHistory(History *history, MsgId topicRootId) {
 	return unlink;
 }
 
+bool Notification::canMergeWith(
+		not_null<History*> history,
+		MsgId topicRootId) const {
+	return (_history == history)
+		&& (_topicRootId == topicRootId)
+		&& _item
+		&& _reaction.empty()
+		&& !_fromScheduled
+		&& !isReplying()
+		&& !isHiding()
+		&& (crl::now() - std::max(_started, _lastMerged)
+			< kMergeBurstTimeout);
+}
+
+void Notification::mergeWith(
+		const QString &author,
+		not_null<HistoryItem*> item) {
+	_author = author;
+	_item = item;
+	_lastMerged = crl::now();
+	updateNotifyDisplay();
+	if (_hideTimer.isActive()) {
+		_hideTimer.start(st::notifyWaitLongHide);
+	}
+}
+
 bool Notification::unlinkSession(not_null<Main::Session*> session) {
 	const auto unlink = _history && (&_history->session() == session);
 	if (unlink) {
@@ -62,6 +62,7 @@ private:
 		rpl::lifetime subscription;
 		rpl::lifetime lifetime;
 	};
+	struct QueuedNotification;
 
 	[[nodiscard]] QPixmap hiddenUserpicPlaceholder() const;
 
@@ -78,6 +79,8 @@ private:
 	void doMaybeFlashBounce(Fn<void()> flashBounce) override;
 
 	void showNextFromQueue();
+	[[nodiscard]] bool takeCreateToken();
+	[[nodiscard]] bool mergeIntoExisting(const QueuedNotification &queued);
 	void unlinkFromShown(Notification *remove);
 	void startAllHiding();
 	void stopAllHiding();
@@ -96,6 +99,10 @@ private:
 
 	void subscribeToSession(not_null<Main::Session*> session);
 
+	[[nodiscard]] QImage takeCache(QSize size);
+	void releaseCache(QImage &&cache);
+
+	std::vector<QImage> _cachePool;
 	std::vector<std::unique_ptr<Notification>> _notifications;
 	base::flat_map<
 		not_null<Main::Session*>,
@@ -106,6 +113,13 @@ private:
 	bool _positionsOutdated = false;
 	base::Timer _inputCheckTimer;
 
+	int _createTokens = 0;
+	crl::time _createTokensUpdated = 0;
+	base::Timer _createTimer;
+
+	int64 _shownCount = 0;
+	int64 _mergedCount = 0;
+
 	struct QueuedNotification {
 		QueuedNotification(NotificationFields &&fields);
 
@@ -146,6 +160,9 @@ public:
 	bool isShowing() const {
 		return _a_opacity.animating() && !_hiding;
 	}
+	bool isHiding() const {
+		return _hiding;
+	}
 
 	void updateOpacity();
 	void changeShift(int top);
@@ -214,6 +231,7 @@ public:
 		QPoint startPosition,
 		int shift,
 		Direction shiftDirection);
+	~Notification();
 
 	void startHiding();
 	void stopHiding();
@@ -235,6 +253,10 @@ public:
 	bool unlinkItem(HistoryItem *del);
 	bool unlinkHistory(History *history = nullptr, MsgId topicRootId = 0);
 	bool unlinkSession(not_null<Main::Session*> session);
+	[[nodiscard]] bool canMergeWith(
+		not_null<History*> history,
+		MsgId topicRootId) const;
+	void mergeWith(const QString &author, not_null<HistoryItem*> item);
 	bool checkLastInput(
 		bool hasReplyingNotifications,
 		std::optional<crl::time> lastInputTime);
@@ -283,6 +305,7 @@ private:
 	QPixmap _buttonsCache;
 
 	crl::time _started;
+	crl::time _lastMerged = 0;
 
 	History *_history = nullptr;
 	Data::ForumTopic *_topic = nullptr;
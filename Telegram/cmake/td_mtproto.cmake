@@ -29,6 +29,8 @@ PRIVATE
     mtproto/details/mtproto_received_ids_manager.h
     mtproto/details/mtproto_rsa_public_key.cpp
     mtproto/details/mtproto_rsa_public_key.h
+    mtproto/details/mtproto_rpc_stats.cpp
+    mtproto/details/mtproto_rpc_stats.h
     mtproto/details/mtproto_serialized_request.cpp
     mtproto/details/mtproto_serialized_request.h
     mtproto/details/mtproto_tcp_socket.cpp
@@ -63,3 +65,7 @@ PUBLIC
 PRIVATE
     desktop-app::external_zlib
 )
+
+if (TDESKTOP_NETWORK_EMULATION)
+    target_compile_definitions(td_mtproto PRIVATE TDESKTOP_NETWORK_EMULATION)
+endif()